@@ -0,0 +1,304 @@
+#include "FxMemPool.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/** Stored before every block to find the size class and owning pool when it is freed */
+struct alignas(16) FxMemPoolBlockHeader
+{
+    /// Pool that the block was allocated from, or nullptr if the block was allocated by the system
+    FxMemPool* Owner;
+
+    /// Usable size of the block in bytes
+    uint32 Capacity;
+
+    uint32 SizeClass;
+};
+
+static_assert(sizeof(FxMemPoolBlockHeader) == 16);
+
+static inline FxMemPoolBlockHeader* FxGetBlockHeader(void* ptr)
+{
+    return reinterpret_cast<FxMemPoolBlockHeader*>(static_cast<uint8*>(ptr) - sizeof(FxMemPoolBlockHeader));
+}
+
+static inline uint32 FxGetSizeClass(uint32 size)
+{
+    uint32 size_class = 0;
+    uint32 class_size = FxMemPool::MinBlockSize;
+
+    while (class_size < size) {
+        class_size <<= 1;
+        size_class++;
+    }
+
+    return size_class;
+}
+
+static inline uint32 FxGetSizeClassCapacity(uint32 size_class)
+{
+    return FxMemPool::MinBlockSize << size_class;
+}
+
+/**
+ * Allocates a block directly from the system. These are used for sizes past the largest class, and
+ * for allocations made after the calling thread's pool has been released.
+ */
+static void* FxAllocSystemBlock(uint32 size)
+{
+    FxMemPoolBlockHeader* header = static_cast<FxMemPoolBlockHeader*>(malloc(sizeof(FxMemPoolBlockHeader) + size));
+    if (header == nullptr) {
+        return nullptr;
+    }
+
+    header->Owner = nullptr;
+    header->Capacity = size;
+    header->SizeClass = FxMemPool::SizeClassCount;
+
+    return header + 1;
+}
+
+// The pool of the calling thread. These are trivially destructible, so unlike the holder below they can
+// still be read by destructors that run after the holder during thread exit, such as those of static IOs.
+static thread_local FxMemPool* tThreadPool = nullptr;
+static thread_local bool tIsThreadPoolReleased = false;
+
+/**
+ * Owns the pool for a thread. If blocks from the pool are still in use when the thread exits
+ * (for example, a buffer handed to another thread), the pool is released by the last Free instead.
+ */
+struct FxMemPoolThreadHolder
+{
+    FxMemPool* Pool = new FxMemPool;
+
+    ~FxMemPoolThreadHolder()
+    {
+        tThreadPool = nullptr;
+        tIsThreadPoolReleased = true;
+
+        // Drop the thread's reference, the pool is deleted here or by the Free of its last block
+        Pool->ReleaseReference();
+    }
+};
+
+FxMemPool* FxMemPool::GetThreadPool()
+{
+    if (tThreadPool == nullptr && !tIsThreadPoolReleased) {
+        static thread_local FxMemPoolThreadHolder holder;
+        tThreadPool = holder.Pool;
+    }
+
+    return tThreadPool;
+}
+
+FxMemPool& FxMemPool::GetGlobalPool()
+{
+    FxMemPool* pool = GetThreadPool();
+
+    if (pool == nullptr) {
+        printf("The memory pool for this thread has already been released!\n");
+        abort();
+    }
+
+    return *pool;
+}
+
+FxMemPool::~FxMemPool()
+{
+    for (Arena& arena : mArenas) {
+        free(arena.Data);
+    }
+}
+
+void FxMemPool::Create(uint32 arena_size_kb)
+{
+    mArenaSize = arena_size_kb * 1024;
+}
+
+uint8* FxMemPool::AllocFromArena(uint32 size)
+{
+    if (mArenas.empty() || mArenaOffset + size > mArenas.back().Size) {
+        const uint32 arena_size = (size > mArenaSize) ? size : mArenaSize;
+
+        uint8* data = static_cast<uint8*>(malloc(arena_size));
+        if (data == nullptr) {
+            return nullptr;
+        }
+
+        mArenas.push_back(Arena{ data, arena_size });
+        mArenaOffset = 0;
+    }
+
+    uint8* block = mArenas.back().Data + mArenaOffset;
+    mArenaOffset += size;
+
+    return block;
+}
+
+void* FxMemPool::AllocBlock(uint32 size)
+{
+    FxMemPoolBlockHeader* header = nullptr;
+
+    if (size > MaxBlockSize) {
+        // Too large to pool, allocate directly from the system
+        return FxAllocSystemBlock(size);
+    }
+
+    const uint32 size_class = FxGetSizeClass(size);
+
+    if (mFreeLists[size_class] == nullptr) {
+        DrainRemoteFrees();
+    }
+
+    FreeBlock* free_block = mFreeLists[size_class];
+
+    if (free_block != nullptr) {
+        mFreeLists[size_class] = free_block->Next;
+        header = FxGetBlockHeader(free_block);
+    }
+    else {
+        const uint32 capacity = FxGetSizeClassCapacity(size_class);
+
+        header = reinterpret_cast<FxMemPoolBlockHeader*>(AllocFromArena(sizeof(FxMemPoolBlockHeader) + capacity));
+        if (header == nullptr) {
+            return nullptr;
+        }
+
+        header->Owner = this;
+        header->Capacity = capacity;
+        header->SizeClass = size_class;
+    }
+
+    mLiveBlocks.fetch_add(1, std::memory_order_relaxed);
+
+    return header + 1;
+}
+
+void* FxMemPool::AllocForThread(uint32 size)
+{
+    FxMemPool* pool = GetThreadPool();
+
+    if (pool == nullptr) {
+        // The thread is exiting and its pool is gone
+        return FxAllocSystemBlock(size);
+    }
+
+    return pool->AllocBlock(size);
+}
+
+void* FxMemPool::ReallocForThread(void* ptr, uint32 size)
+{
+    if (ptr == nullptr) {
+        return AllocForThread(size);
+    }
+
+    FxMemPoolBlockHeader* header = FxGetBlockHeader(ptr);
+
+    if (header->Capacity >= size) {
+        return ptr;
+    }
+
+    void* new_block = AllocForThread(size);
+    if (new_block == nullptr) {
+        return nullptr;
+    }
+
+    memcpy(new_block, ptr, header->Capacity);
+    Free(ptr);
+
+    return new_block;
+}
+
+void FxMemPool::Free(void* ptr)
+{
+    if (ptr == nullptr) {
+        return;
+    }
+
+    FxMemPoolBlockHeader* header = FxGetBlockHeader(ptr);
+    FxMemPool* owner = header->Owner;
+
+    if (owner == nullptr) {
+        free(header);
+        return;
+    }
+
+    // This does not create or touch the thread's pool, so it is safe after the pool has been released at exit
+    if (owner == tThreadPool) {
+        owner->FreeLocal(ptr);
+        return;
+    }
+
+    // The block belongs to another thread's pool, push it onto that pool's remote free list
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->Next = owner->mRemoteFrees.load(std::memory_order_relaxed);
+
+    while (!owner->mRemoteFrees.compare_exchange_weak(block->Next, block, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+
+    // The owner may have exited, so the pool cannot be touched after this
+    owner->ReleaseReference();
+}
+
+void FxMemPool::ReleaseReference()
+{
+    // Whichever side drops the count to zero, the exiting thread or the last remote Free, deletes the pool
+    if (mLiveBlocks.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete this;
+    }
+}
+
+bool FxMemPool::Reset()
+{
+    // Remote frees push their block before dropping the count, so once the count shows no live blocks
+    // every freed block is either on a free list or waiting on the remote list
+    if (mLiveBlocks.load(std::memory_order_acquire) != 1) {
+        return false;
+    }
+
+    // Take the remote blocks off the list so they are not returned after the arenas are rewound
+    mRemoteFrees.exchange(nullptr, std::memory_order_acquire);
+
+    for (FreeBlock*& free_list : mFreeLists) {
+        free_list = nullptr;
+    }
+
+    if (!mArenas.empty()) {
+        for (size_t i = 1; i < mArenas.size(); i++) {
+            free(mArenas[i].Data);
+        }
+
+        mArenas.resize(1);
+    }
+
+    mArenaOffset = 0;
+
+    return true;
+}
+
+void FxMemPool::FreeLocal(void* ptr)
+{
+    FxMemPoolBlockHeader* header = FxGetBlockHeader(ptr);
+
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->Next = mFreeLists[header->SizeClass];
+    mFreeLists[header->SizeClass] = block;
+
+    mLiveBlocks.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void FxMemPool::DrainRemoteFrees()
+{
+    FreeBlock* block = mRemoteFrees.exchange(nullptr, std::memory_order_acquire);
+
+    while (block != nullptr) {
+        FreeBlock* next = block->Next;
+        const uint32 size_class = FxGetBlockHeader(block)->SizeClass;
+
+        block->Next = mFreeLists[size_class];
+        mFreeLists[size_class] = block;
+
+        block = next;
+    }
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "FxTypes.hpp"
+
+#include <atomic>
+#include <vector>
+
+/*
+*    FxMemPool
+*
+*       A thread-local pool allocator used for section buffers when FX_USE_MEMPOOL is defined.
+*
+*       - Each thread has its own pool, so allocating and freeing on the same thread never locks.
+*
+*       - Allocations are rounded up to a power of two size class (64 bytes to 1 MB) and are carved
+*         from large arena chunks. Freed blocks are kept on a free list per size class and are reused
+*         by the next allocation of that class. Allocations larger than the largest class go directly
+*         to the system allocator.
+*
+*       - Blocks freed on another thread are pushed onto the owning pool's remote free list, and are
+*         reclaimed by the owning thread on its next allocation. If a thread exits while its blocks
+*         are still in use, its pool is kept alive until the last of those blocks is freed. Blocks
+*         allocated after the thread's pool has been released at exit come from the system allocator.
+*
+*       - Once every block from a pool has been freed, Reset() rewinds its arenas in one step.
+*
+*       - Deserialization reads directly into the destination values and decodes varint arrays
+*         through a fixed size stack buffer, so there is no separate scratch allocator.
+*/
+class FxMemPool
+{
+public:
+    /// Smallest usable size of a block
+    static constexpr uint32 MinBlockSize = 64;
+
+    /// Largest usable size of a block, allocations past this size are not pooled
+    static constexpr uint32 MaxBlockSize = 1 << 20;
+
+    /// Number of power of two size classes between MinBlockSize and MaxBlockSize
+    static constexpr uint32 SizeClassCount = 15;
+
+    /// Size of each arena chunk if Create() is not called
+    static constexpr uint32 DefaultArenaSizeKb = 1024;
+
+public:
+    FxMemPool() = default;
+    ~FxMemPool();
+
+    FxMemPool(const FxMemPool& other) = delete;
+    FxMemPool& operator = (const FxMemPool& other) = delete;
+
+    /** Returns the memory pool for the calling thread. This must not be called while the thread is exiting. */
+    static FxMemPool& GetGlobalPool();
+
+    /** Sets the size of the arena chunks that blocks are carved from */
+    void Create(uint32 arena_size_kb);
+
+    /** Allocates a block from the calling thread's pool */
+    template <typename T>
+    static T* Alloc(uint32 size)
+    {
+        return static_cast<T*>(AllocForThread(size));
+    }
+
+    /** Resizes a block, returning the same pointer if the block already has room for `size` bytes */
+    template <typename T>
+    static T* Realloc(T* ptr, uint32 size)
+    {
+        return static_cast<T*>(ReallocForThread(ptr, size));
+    }
+
+    /** Frees a block allocated with Alloc or Realloc. This can be called from any thread. */
+    static void Free(void* ptr);
+
+    void* AllocBlock(uint32 size);
+
+    /**
+     * Releases every block at once by rewinding the arenas and clearing the free lists, keeping the first
+     * arena for reuse. Returns false without changing anything if a block from the pool is still in use.
+     */
+    bool Reset();
+
+    /** Returns the number of blocks that have been allocated from this pool and not yet freed */
+    uint32 GetLiveBlockCount() const
+    {
+        // The owning thread holds one reference in the count
+        return mLiveBlocks.load(std::memory_order_relaxed) - 1;
+    }
+
+private:
+    friend struct FxMemPoolThreadHolder;
+
+    struct FreeBlock
+    {
+        FreeBlock* Next;
+    };
+
+    struct Arena
+    {
+        uint8* Data;
+        uint32 Size;
+    };
+
+    /** Returns the calling thread's pool, or nullptr if it has already been released by the exiting thread */
+    static FxMemPool* GetThreadPool();
+
+    static void* AllocForThread(uint32 size);
+    static void* ReallocForThread(void* ptr, uint32 size);
+
+    void FreeLocal(void* ptr);
+    void DrainRemoteFrees();
+
+    /** Drops one reference from the live count, deleting the pool if it was the last one */
+    void ReleaseReference();
+
+    uint8* AllocFromArena(uint32 size);
+
+private:
+    uint32 mArenaSize = DefaultArenaSizeKb * 1024;
+
+    FreeBlock* mFreeLists[SizeClassCount] = { };
+    std::atomic<FreeBlock*> mRemoteFrees = nullptr;
+    /// Number of live blocks, plus one reference held by the owning thread until it exits
+    std::atomic<uint32> mLiveBlocks = 1;
+
+    std::vector<Arena> mArenas;
+    uint32 mArenaOffset = 0;
+};
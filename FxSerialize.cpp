@@ -4,6 +4,32 @@
 #include "FxTypes.hpp"
 #include "FxUtil.hpp"
 
+#include <cstdlib>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define FX_SERIALIZE_X86 1
+#include <immintrin.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define FX_TARGET_SSSE3
+#define FX_TARGET_AVX2
+#else
+#define FX_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define FX_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
 #define REVERT_INDEX_AFTER_SCOPE \
     uint32 old_index_ = Index; \
     FxDefer([&] { Index = old_index_; })
@@ -24,103 +50,284 @@ static FILE* FxFileOpen(const char* filename, const char* mode)
 
 void FxSerializerBaseSection::Create(uint32 buffer_size)
 {
+    Index = 0;
+
+    if (buffer_size == 0) {
+        return;
+    }
+
+    if (buffer_size == Capacity && !IsReadOnly) {
+        Size = Capacity;
+        return;
+    }
+
+    uint8* new_data = ReallocData(buffer_size);
+
+    if (new_data == nullptr) {
+        printf("Could not allocate section of %u bytes!\n", buffer_size);
+        abort();
+    }
+
+    Data = new_data;
     Size = buffer_size;
+    Capacity = buffer_size;
+    IsReadOnly = false;
+}
+
+void FxSerializerBaseSection::PrepareForRead(uint32 length)
+{
+    if (Capacity < length) {
+        Create(length);
+    }
+
     Index = 0;
-    Data = FX_ALLOC_MEM(uint8, Size);
+    Size = length;
 }
 
-FxSerializedType FxSerializerTypeSection::ReadType(uint32 index)
+void FxSerializerBaseSection::Grow(uint64 required_size)
 {
-    REVERT_INDEX_AFTER_SCOPE;
-    Index = index;
+    // Section lengths are stored as uint32s in the file, so we cannot grow past that.
+    if (required_size > UINT32_MAX) {
+        printf("Section cannot grow past %u bytes! (requested %llu)\n", UINT32_MAX, static_cast<unsigned long long>(required_size));
+        abort();
+    }
 
-    uint8 sanity_header = Read8();
-    if (sanity_header != TypeIdentHeader) {
-        printf("Sanity header does not match!\n");
-        return {};
+    if (IsReadOnly) {
+        // Read only memory such as a mapped file cannot be written to, so move all of it into our own buffer first
+        if (required_size < Size) {
+            required_size = Size;
+        }
+    }
+    // Reads limit the size to the loaded length, the buffer itself may already be large enough
+    else if (required_size <= Capacity) {
+        Size = Capacity;
+        return;
     }
 
-    FxSerializedType type;
-    type.Id = Read16();
-    type.Size = Read16();
+    const uint32 first_size = (InitialCapacity < MinimumCapacity) ? MinimumCapacity : InitialCapacity;
 
-    uint8 number_of_members = Read8();
+    uint64 new_size = (Capacity < first_size) ? first_size : static_cast<uint64>(Capacity) * 2;
 
-    for (int i = 0; i < number_of_members; i++) {
-        Read16(); // Skip size of member
+    if (new_size < required_size) {
+        new_size = required_size;
+    }
+    if (new_size > UINT32_MAX) {
+        new_size = UINT32_MAX;
+    }
 
-        uint16 member_id = Read16();
-        uint32 member_index = FindIndexFromTypeId(member_id);
+    uint8* new_data = ReallocData(static_cast<uint32>(new_size));
 
-        // Push the member to the type
-        FxSerializedType member = ReadType(member_index);
-        type.Members.emplace_back(member);
+    if (new_data == nullptr) {
+        printf("Could not grow section to %llu bytes!\n", static_cast<unsigned long long>(new_size));
+        abort();
     }
 
-    uint8 sanity_footer = Read8();
-    if (sanity_footer != TypeIdentFooter) {
-        printf("Sanity footer does not match!\n");
+    Data = new_data;
+    Size = static_cast<uint32>(new_size);
+    Capacity = Size;
+    IsReadOnly = false;
+}
+
+uint8* FxSerializerBaseSection::ReallocData(uint32 new_size)
+{
+    if (!IsExternal) {
+        return FX_REALLOC_MEM(uint8, Data, new_size);
     }
 
-    return type;
+    // We cannot resize memory that we do not own, so move the data into our own buffer
+    uint8* new_data = FX_ALLOC_MEM(uint8, new_size);
+
+    if (new_data != nullptr) {
+        memcpy(new_data, Data, (Size < new_size) ? Size : new_size);
+        IsExternal = false;
+    }
+
+    return new_data;
 }
 
-bool FxSerializerTypeSection::IsTypePreviouslyWritten(uint16 type_id)
+void FxSerializerTypeSection::BuildTypeTable()
 {
-    for (TypeEntry& tp : mRegisteredTypeIds) {
-        if (tp.Id == type_id) {
-            // Type is already written, skip
-            return true;
+    REVERT_INDEX_AFTER_SCOPE;
+
+    mTypes.clear();
+    mMemberTypeIndices.clear();
+
+    mTypes.reserve(mRegisteredTypeIds.size());
+
+    for (const TypeEntry& entry : mRegisteredTypeIds) {
+        Index = entry.Offset;
+
+        uint8 sanity_header = Read8();
+        if (sanity_header != TypeIdentHeader) {
+            printf("Sanity header does not match for type at %u!\n", entry.Offset);
+            continue;
         }
+
+        FxSerializedType type;
+        type.Id = Read16();
+        type.Size = Read16();
+        type.Offset = entry.Offset;
+        type.MembersStart = static_cast<uint32>(mMemberTypeIndices.size());
+        type.MembersCount = Read8();
+
+        for (uint32 i = 0; i < type.MembersCount; i++) {
+            Read16(); // Skip size of member
+
+            // Store the member's type id for now, these are resolved to indices once all types are sorted
+            mMemberTypeIndices.push_back(Read16());
+        }
+
+        uint8 sanity_footer = Read8();
+        if (sanity_footer != TypeIdentFooter) {
+            printf("Sanity footer does not match for type %04x!\n", type.Id);
+        }
+
+        mTypes.push_back(type);
     }
-    return false;
+
+    std::sort(mTypes.begin(), mTypes.end(), [](const FxSerializedType& a, const FxSerializedType& b) { return a.Id < b.Id; });
+
+    mIsTypeIndexStale = false;
+
+    for (uint32& member : mMemberTypeIndices) {
+        const uint16 member_id = static_cast<uint16>(member);
+        const FxSerializedType* member_type = FindType(member_id);
+
+        if (member_type == nullptr) {
+            printf("Member type %04x is not in the type section!\n", member_id);
+            member = TypeNotFound;
+            continue;
+        }
+
+        member = static_cast<uint32>(member_type - mTypes.data());
+    }
+}
+
+const FxSerializedType* FxSerializerTypeSection::FindType(uint16 id)
+{
+    if (mIsTypeIndexStale) {
+        BuildTypeTable();
+    }
+
+    auto it = std::lower_bound(mTypes.begin(), mTypes.end(), id, [](const FxSerializedType& type, uint16 id) { return type.Id < id; });
+
+    if (it == mTypes.end() || it->Id != id) {
+        return nullptr;
+    }
+
+    return &(*it);
 }
 
 uint32 FxSerializerTypeSection::FindIndexFromTypeId(uint16 id)
+{
+    const FxSerializedType* type = FindType(id);
+
+    if (type == nullptr) {
+        return TypeNotFound;
+    }
+
+    return type->Offset;
+}
+
+void FxSerializerTypeSection::IndexTypes(uint32 length)
 {
     REVERT_INDEX_AFTER_SCOPE;
     Index = 0;
 
-    uint32 entry_index = 0;
+    ClearRegisteredTypes();
 
-    bool found_id = false;
+    if (length > Size) {
+        length = Size;
+    }
 
-    while (!found_id && Index < Size) {
+    // Each entry is at least a header, id, size, member count and footer
+    constexpr uint32 min_entry_size = 7;
 
-        entry_index = Index;
+    while (Index + min_entry_size <= length) {
+        const uint32 entry_index = Index;
 
         uint8 sanity_header = Read8();
         if (sanity_header != TypeIdentHeader) {
-            printf("Sanity header error when searching for Type ID %04x (%02X != %02X)\n", id, sanity_header, TypeIdentHeader);
+            printf("Sanity header error when indexing types at %u (%02X != %02X)\n", entry_index, sanity_header, TypeIdentHeader);
             break;
         }
 
-        uint16 type_id = Read16();
+        const uint16 type_id = Read16();
+        Read16(); // size
 
-        // We found the id, break to return the index for the start of the entry
-        if (type_id == id) {
-            break;
-        }
+        const uint8 number_of_members = Read8();
 
-        Read16(); // size
+        // Skip the size and type id of each member
+        Index += number_of_members * (sizeof(uint16) * 2);
 
-        uint8 number_of_members = Read8();
-        for (int i = 0; i < number_of_members; i++) {
-            Read16(); // size
-            Read16(); // type id
+        if (Index >= length) {
+            printf("Type entry %04x runs past the end of the section\n", type_id);
+            break;
         }
 
         uint8 sanity_footer = Read8();
-
         if (sanity_footer != TypeIdentFooter) {
-            printf("Sanity footer error when searching for Type ID\n");
+            printf("Sanity footer error when indexing Type ID %04x\n", type_id);
             break;
         }
 
-        // Continue to next entry...
+        AddRegisteredType(type_id, entry_index);
     }
 
-    return entry_index;
+    mIsTypeIndexStale = true;
+}
+
+bool FxSerializerTypeSection::IsTypeRecordAt(uint32 offset, const uint8* record, uint32 size) const
+{
+    if (Data == nullptr || static_cast<uint64>(offset) + size > Size) {
+        return false;
+    }
+
+    const uint8* stored = Data + offset;
+
+    if (!SwapBytes) {
+        return memcmp(stored, record, size) == 0;
+    }
+
+    // The section is in the other byte order. The header, member count and footer are single bytes,
+    // everything else is a pair of uint16s.
+    if (stored[0] != record[0] || stored[5] != record[5] || stored[size - 1] != record[size - 1]) {
+        return false;
+    }
+
+    auto is_swapped_pair = [&](uint32 index) {
+        return stored[index] == record[index + 1] && stored[index + 1] == record[index];
+    };
+
+    for (uint32 index = 1; index < 5; index += sizeof(uint16)) {
+        if (!is_swapped_pair(index)) {
+            return false;
+        }
+    }
+
+    for (uint32 index = 6; index + 1 < size - 1; index += sizeof(uint16)) {
+        if (!is_swapped_pair(index)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool FxSerializerTypeSection::CheckRegisteredType(TypeEntry& entry, const uint8* record, uint32 size, std::string_view type_name)
+{
+    if (IsTypeRecordAt(entry.Offset, record, size)) {
+        // Remember the record so the next write of this type does not compare again
+        entry.Record = record;
+        return true;
+    }
+
+    printf(
+        "Type id %04x for '%.*s' is already used by a different type in the section, the entry is not written! Declare a unique id with FX_SERIALIZABLE_TYPE_ID\n",
+        entry.Id, static_cast<int>(type_name.size()), type_name.data()
+    );
+
+    return false;
 }
 
 ///////////////////////////////
@@ -139,6 +346,21 @@ void FxSerializerIO::WriteToFile(const char* filename)
     uint32 signature = FX_SERIALIZER_IO_FILE_SIGNATURE;
     fwrite(&signature, sizeof(signature), 1, fp);
 
+    // Write the flags, sections are always written in native byte order
+    uint8 flags = GetNativeFlags();
+
+    if (DataSection.UseVarInts) {
+        flags |= FX_SERIALIZER_IO_FLAG_VARINT;
+    }
+    if (DataSection.UseCompactStructs) {
+        flags |= FX_SERIALIZER_IO_FLAG_COMPACT_STRUCTS;
+    }
+    if (mUseDirectory) {
+        flags |= FX_SERIALIZER_IO_FLAG_DIRECTORY;
+    }
+
+    fwrite(&flags, sizeof(flags), 1, fp);
+
     // Write the size of the types section in bytes
     fwrite(&TypeSection.Index, sizeof(uint32), 1, fp);
     // Write the types section
@@ -152,6 +374,22 @@ void FxSerializerIO::WriteToFile(const char* filename)
     // Write the data section
     fwrite(DataSection.Data, 1, DataSection.Index, fp);
 
+    if (mUseDirectory) {
+        SortDirectory();
+
+        uint32 directory_signature = FX_SERIALIZER_IO_SECTION_DIRECTORY_SIGNATURE;
+        fwrite(&directory_signature, sizeof(directory_signature), 1, fp);
+
+        // Write the number of entries, followed by the name hash and offset of each
+        uint32 entry_count = static_cast<uint32>(mDirectory.size());
+        fwrite(&entry_count, sizeof(uint32), 1, fp);
+
+        for (const FxSerializerDirectoryEntry& entry : mDirectory) {
+            fwrite(&entry.NameHash, sizeof(uint32), 1, fp);
+            fwrite(&entry.Offset, sizeof(uint32), 1, fp);
+        }
+    }
+
     fclose(fp);
 }
 
@@ -173,11 +411,36 @@ void FxSerializerIO::ReadFromFile(const char* filename)
         fclose(fp);
     });
 
+    // Returns true if `length` more bytes can be read from the file
+    auto is_in_file = [&](uint64 length) {
+        return static_cast<uint64>(ftell(fp)) + length <= size;
+    };
+
+    ReleaseMappedFile();
+
+    bool swap_bytes = false;
+    bool has_directory = false;
+    uint32 size_of_data = 0;
+
     {
         // Read in the file signature (expect "FXSD") as a uint32 to compare with our multichar value
         uint32 signature_buffer = 0;
         fread(&signature_buffer, sizeof(uint32), 1, fp);
 
+        uint8 flags = 0;
+        fread(&flags, sizeof(uint8), 1, fp);
+
+        // If the file was written on a machine with a different byte order, all values need to be swapped
+        swap_bytes = (flags & FX_SERIALIZER_IO_FLAG_LITTLE_ENDIAN) != (GetNativeFlags() & FX_SERIALIZER_IO_FLAG_LITTLE_ENDIAN);
+
+        if (swap_bytes) {
+            signature_buffer = FxByteSwap(signature_buffer);
+        }
+
+        DataSection.UseVarInts = (flags & FX_SERIALIZER_IO_FLAG_VARINT) != 0;
+        DataSection.UseCompactStructs = (flags & FX_SERIALIZER_IO_FLAG_COMPACT_STRUCTS) != 0;
+        has_directory = (flags & FX_SERIALIZER_IO_FLAG_DIRECTORY) != 0;
+
         const uint32 expected_signature = FX_SERIALIZER_IO_FILE_SIGNATURE;
 
         if (signature_buffer != expected_signature) {
@@ -189,14 +452,33 @@ void FxSerializerIO::ReadFromFile(const char* filename)
         uint32 size_of_types;
         fread(&size_of_types, sizeof(uint32), 1, fp);
 
+        if (swap_bytes) {
+            size_of_types = FxByteSwap(size_of_types);
+        }
+
+        if (!is_in_file(size_of_types)) {
+            printf("Types section length of %u bytes is larger than the file!\n", size_of_types);
+            return;
+        }
+
         // Read in the types
+        // The buffer is only reallocated if it is too small, but reads are limited to the section length
+        TypeSection.PrepareForRead(size_of_types);
+        TypeSection.SwapBytes = swap_bytes;
+
         fread(TypeSection.Data, 1, size_of_types, fp);
+
+        TypeSection.IndexTypes(size_of_types);
     }
     {
         // Read in the data signature (expect ".DAT") as a uint32 to compare with our multichar value
         uint32 signature_buffer = 0;
         fread(&signature_buffer, sizeof(uint32), 1, fp);
 
+        if (swap_bytes) {
+            signature_buffer = FxByteSwap(signature_buffer);
+        }
+
         const uint32 expected_data_signature = FX_SERIALIZER_IO_SECTION_DATA_SIGNATURE;
 
         if (signature_buffer != expected_data_signature) {
@@ -204,12 +486,277 @@ void FxSerializerIO::ReadFromFile(const char* filename)
             return;
         }
 
-        uint32 size_of_data;
         fread(&size_of_data, sizeof(uint32), 1, fp);
 
+        if (swap_bytes) {
+            size_of_data = FxByteSwap(size_of_data);
+        }
+
+        if (!is_in_file(size_of_data)) {
+            printf("Data section length of %u bytes is larger than the file!\n", size_of_data);
+            return;
+        }
+
         // Read in the data section
+        DataSection.PrepareForRead(size_of_data);
+        DataSection.SwapBytes = swap_bytes;
+
         fread(DataSection.Data, 1, size_of_data, fp);
     }
+
+    mDirectory.clear();
+
+    if (has_directory) {
+        // Read in the directory signature (expect ".DIR")
+        uint32 signature_buffer = 0;
+        fread(&signature_buffer, sizeof(uint32), 1, fp);
+
+        if (swap_bytes) {
+            signature_buffer = FxByteSwap(signature_buffer);
+        }
+
+        const uint32 expected_directory_signature = FX_SERIALIZER_IO_SECTION_DIRECTORY_SIGNATURE;
+
+        if (signature_buffer != expected_directory_signature) {
+            printf("File directory signature is incorrect!\n");
+            return;
+        }
+
+        uint32 entry_count = 0;
+        fread(&entry_count, sizeof(uint32), 1, fp);
+
+        if (swap_bytes) {
+            entry_count = FxByteSwap(entry_count);
+        }
+
+        if (!is_in_file(static_cast<uint64>(entry_count) * sizeof(FxSerializerDirectoryEntry))) {
+            printf("Directory of %u entries is larger than the file!\n", entry_count);
+            return;
+        }
+
+        mDirectory.resize(entry_count);
+
+        for (FxSerializerDirectoryEntry& entry : mDirectory) {
+            fread(&entry.NameHash, sizeof(uint32), 1, fp);
+            fread(&entry.Offset, sizeof(uint32), 1, fp);
+
+            if (swap_bytes) {
+                entry.NameHash = FxByteSwap(entry.NameHash);
+                entry.Offset = FxByteSwap(entry.Offset);
+            }
+
+            // Every entry must start with a full header inside the data section, or seeking to it would read past the end
+            if (static_cast<uint64>(entry.Offset) + FxSerializerDataSection::EntryHeaderSize > size_of_data) {
+                printf("Directory entry %08x at offset %u is outside of the data section!\n", entry.NameHash, entry.Offset);
+                mDirectory.clear();
+                return;
+            }
+        }
+
+        // The directory is written in sorted order
+        mIsDirectorySorted = true;
+    }
+}
+
+bool FxSerializerIO::MapFromFile(const char* filename)
+{
+    FxSerializerMappedFile mapped_file;
+
+    if (!mapped_file.Map(filename)) {
+        return false;
+    }
+
+    if (!ReadFromMemory(mapped_file.GetData())) {
+        return false;
+    }
+
+    // The sections now point into the new mapping, so the previous one can be released
+    mMappedFile = std::move(mapped_file);
+
+    return true;
+}
+
+bool FxSerializerIO::ReadFromMemory(std::span<const uint8> file)
+{
+    uint64 offset = 0;
+
+    // Reads a value from the file, returning false if it would read past the end
+    auto read_value = [&](auto& value) {
+        if (offset + sizeof(value) > file.size()) {
+            return false;
+        }
+
+        memcpy(&value, file.data() + offset, sizeof(value));
+        offset += sizeof(value);
+
+        return true;
+    };
+
+    // Reads a section length, returning false if the section runs past the end of the file
+    auto read_length = [&](uint32& length, bool swap_bytes, uint64 element_size) {
+        if (!read_value(length)) {
+            return false;
+        }
+
+        if (swap_bytes) {
+            length = FxByteSwap(length);
+        }
+
+        return offset + static_cast<uint64>(length) * element_size <= file.size();
+    };
+
+    if (file.size() > UINT32_MAX) {
+        printf("File of %zu bytes is too large to read!\n", file.size());
+        return false;
+    }
+
+    uint32 signature = 0;
+    uint8 flags = 0;
+
+    if (!read_value(signature) || !read_value(flags)) {
+        printf("File is too small to contain a header!\n");
+        return false;
+    }
+
+    // If the file was written on a machine with a different byte order, all values need to be swapped
+    const bool swap_bytes = (flags & FX_SERIALIZER_IO_FLAG_LITTLE_ENDIAN) != (GetNativeFlags() & FX_SERIALIZER_IO_FLAG_LITTLE_ENDIAN);
+
+    if (swap_bytes) {
+        signature = FxByteSwap(signature);
+    }
+
+    if (signature != FX_SERIALIZER_IO_FILE_SIGNATURE) {
+        printf("File signature is incorrect!\n");
+        return false;
+    }
+
+    uint32 size_of_types = 0;
+    if (!read_length(size_of_types, swap_bytes, 1)) {
+        printf("Types section length of %u bytes is larger than the file!\n", size_of_types);
+        return false;
+    }
+
+    const uint64 types_offset = offset;
+    offset += size_of_types;
+
+    uint32 data_signature = 0;
+    read_value(data_signature);
+
+    if (swap_bytes) {
+        data_signature = FxByteSwap(data_signature);
+    }
+
+    if (data_signature != FX_SERIALIZER_IO_SECTION_DATA_SIGNATURE) {
+        printf("File data signature is incorrect!\n");
+        return false;
+    }
+
+    uint32 size_of_data = 0;
+    if (!read_length(size_of_data, swap_bytes, 1)) {
+        printf("Data section length of %u bytes is larger than the file!\n", size_of_data);
+        return false;
+    }
+
+    const uint64 data_offset = offset;
+    offset += size_of_data;
+
+    std::vector<FxSerializerDirectoryEntry> directory;
+
+    if (flags & FX_SERIALIZER_IO_FLAG_DIRECTORY) {
+        uint32 directory_signature = 0;
+        read_value(directory_signature);
+
+        if (swap_bytes) {
+            directory_signature = FxByteSwap(directory_signature);
+        }
+
+        if (directory_signature != FX_SERIALIZER_IO_SECTION_DIRECTORY_SIGNATURE) {
+            printf("File directory signature is incorrect!\n");
+            return false;
+        }
+
+        uint32 entry_count = 0;
+        if (!read_length(entry_count, swap_bytes, sizeof(FxSerializerDirectoryEntry))) {
+            printf("Directory of %u entries is larger than the file!\n", entry_count);
+            return false;
+        }
+
+        directory.resize(entry_count);
+
+        for (FxSerializerDirectoryEntry& entry : directory) {
+            read_value(entry.NameHash);
+            read_value(entry.Offset);
+
+            if (swap_bytes) {
+                entry.NameHash = FxByteSwap(entry.NameHash);
+                entry.Offset = FxByteSwap(entry.Offset);
+            }
+
+            if (static_cast<uint64>(entry.Offset) + FxSerializerDataSection::EntryHeaderSize > size_of_data) {
+                printf("Directory entry %08x at offset %u is outside of the data section!\n", entry.NameHash, entry.Offset);
+                return false;
+            }
+        }
+    }
+
+    // The file is valid, point the sections at it
+    DataSection.UseVarInts = (flags & FX_SERIALIZER_IO_FLAG_VARINT) != 0;
+    DataSection.UseCompactStructs = (flags & FX_SERIALIZER_IO_FLAG_COMPACT_STRUCTS) != 0;
+
+    TypeSection.SetReadOnlyBuffer(file.subspan(types_offset, size_of_types));
+    TypeSection.SwapBytes = swap_bytes;
+    TypeSection.IndexTypes(size_of_types);
+
+    DataSection.SetReadOnlyBuffer(file.subspan(data_offset, size_of_data));
+    DataSection.SwapBytes = swap_bytes;
+
+    mDirectory = std::move(directory);
+    mIsDirectorySorted = true;
+
+    // Anything previously mapped is no longer referenced by the sections
+    mMappedFile.Unmap();
+
+    return true;
+}
+
+void FxSerializerIO::ReleaseMappedFile()
+{
+    if (!mMappedFile.IsMapped()) {
+        return;
+    }
+
+    // Drop the sections' references to the mapped memory before unmapping it
+    TypeSection.Adopt(FxSerializerBuffer());
+    DataSection.Adopt(FxSerializerBuffer());
+
+    TypeSection.Reset();
+    DataSection.Reset();
+
+    mMappedFile.Unmap();
+}
+
+void FxSerializerIO::SortDirectory()
+{
+    if (mIsDirectorySorted) {
+        return;
+    }
+
+    std::stable_sort(mDirectory.begin(), mDirectory.end(), [](const FxSerializerDirectoryEntry& a, const FxSerializerDirectoryEntry& b) { return a.NameHash < b.NameHash; });
+
+    mIsDirectorySorted = true;
+}
+
+uint32 FxSerializerIO::FindEntry(FxHash name_hash)
+{
+    SortDirectory();
+
+    auto it = std::lower_bound(mDirectory.begin(), mDirectory.end(), name_hash, [](const FxSerializerDirectoryEntry& entry, FxHash name_hash) { return entry.NameHash < name_hash; });
+
+    if (it == mDirectory.end() || it->NameHash != name_hash) {
+        return UINT32_MAX;
+    }
+
+    return it->Offset;
 }
 
 void FxSerializerIO::PrintReadableEntry(uint32 start_index)
@@ -221,20 +768,30 @@ void FxSerializerIO::PrintReadableEntry(uint32 start_index)
     const uint16 type_id = DataSection.Read16();
     printf("\nType ID    : "); PrintBinaryValue(type_id);
     printf("\nName Hash  : "); PrintBinaryValue(DataSection.Read32());
+    const uint32 length = DataSection.Read32();
+    printf("\nLength     : %u", length);
     puts("");
 
-    FxSerializedType entry_type = TypeSection.ReadType(TypeSection.FindIndexFromTypeId(type_id));
+    const FxSerializedType* entry_type = TypeSection.FindType(type_id);
 
-    printf("Type {Sz:%d, Members: %zu}\n", entry_type.Size, entry_type.Members.size());
+    if (entry_type == nullptr) {
+        printf("Type %04x is not in the type section!\n", type_id);
+    }
+    else {
+        printf("Type {Sz:%d, Members: %u}\n", entry_type->Size, entry_type->MembersCount);
+
+        for (uint32 i = 0; i < entry_type->MembersCount; i++) {
+            const FxSerializedType* member = TypeSection.GetMemberType(*entry_type, i);
 
-    uint32 total_members_size = 0;
+            if (member == nullptr) {
+                continue;
+            }
 
-    for (FxSerializedType& member : entry_type.Members) {
-        printf("Member(%d, Sz: %d)\n", member.Id, member.Size);
-        total_members_size += member.Size;
+            printf("Member(%d, Sz: %d)\n", member->Id, member->Size);
+        }
     }
-    printf("Total size of members: %u\n", total_members_size);
-    DataSection.Index += total_members_size;
+
+    DataSection.Index += length;
 
     printf("Magic End: "); PrintBinaryValue(DataSection.Read8());
 
@@ -242,33 +799,175 @@ void FxSerializerIO::PrintReadableEntry(uint32 start_index)
 }
 
 
+///////////////////////////////
+// Mapped File
+///////////////////////////////
+
+bool FxSerializerMappedFile::Map(const char* filename)
+{
+    Unmap();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        printf("Could not open file '%s' for mapping!\n", filename);
+        return false;
+    }
+
+    FxDefer([&file] {
+        CloseHandle(file);
+    });
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        printf("Could not map empty file '%s'!\n", filename);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        printf("Could not create mapping for file '%s'!\n", filename);
+        return false;
+    }
+
+    // The view keeps the mapping alive, so the handle can be closed right away
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+
+    if (data == nullptr) {
+        printf("Could not map file '%s'!\n", filename);
+        return false;
+    }
+
+    mData = static_cast<uint8*>(data);
+    mSize = static_cast<size_t>(file_size.QuadPart);
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        printf("Could not open file '%s' for mapping!\n", filename);
+        return false;
+    }
+
+    FxDefer([&fd] {
+        close(fd);
+    });
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+        printf("Could not map empty file '%s'!\n", filename);
+        return false;
+    }
+
+    // The sections never write into the mapping, they copy the data into their own buffer on the first write
+    void* data = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        printf("Could not map file '%s'!\n", filename);
+        return false;
+    }
+
+    mData = static_cast<uint8*>(data);
+    mSize = static_cast<size_t>(file_stat.st_size);
+#endif
+
+    return true;
+}
+
+void FxSerializerMappedFile::Unmap()
+{
+    if (mData == nullptr) {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(mData);
+#else
+    munmap(mData, mSize);
+#endif
+
+    mData = nullptr;
+    mSize = 0;
+}
+
+
+///////////////////////////////
+// Serializer IO Pool
+///////////////////////////////
+
+void FxSerializerIOPool::Create(uint32 count, uint32 buffer_size)
+{
+    mBufferSize = buffer_size;
+    mIOs.reserve(mIOs.size() + count);
+    mFreeIOs.reserve(mFreeIOs.size() + count);
+
+    for (uint32 i = 0; i < count; i++) {
+        FxSerializerIO* io = mIOs.emplace_back(std::make_unique<FxSerializerIO>(buffer_size)).get();
+
+        io->TypeSection.Create(buffer_size);
+        io->DataSection.Create(buffer_size);
+
+        // Fault in the pages now rather than on the first write
+        memset(io->TypeSection.Data, 0, io->TypeSection.Capacity);
+        memset(io->DataSection.Data, 0, io->DataSection.Capacity);
+
+        mFreeIOs.push_back(io);
+    }
+}
+
+FxSerializerIO* FxSerializerIOPool::Acquire()
+{
+    if (mFreeIOs.empty()) {
+        return mIOs.emplace_back(std::make_unique<FxSerializerIO>(mBufferSize)).get();
+    }
+
+    FxSerializerIO* io = mFreeIOs.back();
+    mFreeIOs.pop_back();
+
+    return io;
+}
+
+void FxSerializerIOPool::Release(FxSerializerIO* io)
+{
+    if (io == nullptr) {
+        return;
+    }
+
+    // A mapped file would otherwise stay mapped, and the next user would write into the copy on write mapping
+    io->ReleaseMappedFile();
+    io->Reset();
+
+    // The IO may have loaded these from a file header, so go back to the defaults for the next user
+    io->EnableVarInts(false);
+    io->EnableCompactStructs(false);
+    io->EnableDirectory(false);
+
+    mFreeIOs.push_back(io);
+}
+
+
 /////////////////////////////////////
 // FxSerializeValue specializations
 /////////////////////////////////////
 
-
 template <>
-void FxSerializeValue(FxSerializerIO& writer, const int32& value)
+void FxSerializeValue(FxSerializerIO& writer, const std::string& value)
 {
-    writer.DataSection.Write32(static_cast<uint32>(value));
+    writer.DataSection.WriteString(value);
 }
 
-
 template <>
-void FxSerializeValue(FxSerializerIO& writer, const float32& value)
+void FxSerializeValue(FxSerializerIO& writer, const std::string_view& value)
 {
-    writer.DataSection.Write32(static_cast<uint32>(value));
+    writer.DataSection.WriteString(value);
 }
 
 template <>
-void FxSerializeValue(FxSerializerIO& writer, const std::string& value)
+void FxSerializeValue(FxSerializerIO& writer, const std::span<const uint8>& value)
 {
-    const uint32 str_size = value.size();
+    // Written the same as a std::vector<uint8>, so either can be read back as the other
+    const uint32 count = static_cast<uint32>(value.size());
 
-    // Write the size of the string
-    writer.DataSection.Write16(str_size);
-    writer.DataSection.WriteBuffer(str_size, reinterpret_cast<const uint8_t*>(value.c_str()));
-    writer.DataSection.Write8(0);
+    writer.DataSection.Write32(count);
+    writer.DataSection.WriteBuffer(count, value.data());
 }
 
 
@@ -277,22 +976,306 @@ void FxSerializeValue(FxSerializerIO& writer, const std::string& value)
 /////////////////////////////////////
 
 template <>
-void FxDeserializeValue(FxSerializerIO& reader, int32* value)
+void FxDeserializeValue(FxSerializerIO& reader, std::string* value)
 {
-    (*value) = reader.DataSection.Read32();
+    *value = reader.DataSection.ReadStringView();
 }
 
 template <>
-void FxDeserializeValue(FxSerializerIO& reader, float32* value)
+void FxDeserializeValue(FxSerializerIO& reader, std::string_view* value)
 {
-    (*value) = reader.DataSection.Read32();
+    *value = reader.DataSection.ReadStringView();
 }
 
 template <>
-void FxDeserializeValue(FxSerializerIO& reader, std::string* value)
+void FxDeserializeValue(FxSerializerIO& reader, std::span<const uint8>* value)
+{
+    *value = reader.DataSection.ReadBytesView();
+}
+
+
+/////////////////////////////////////
+// Byte swap kernels
+/////////////////////////////////////
+
+using FxSwapKernel = void (*)(uint8* data, uint32 count);
+
+template <typename WordType>
+static void FxSwapArrayBytesScalar(uint8* data, uint32 count)
+{
+    for (uint32 i = 0; i < count; i++) {
+        WordType word;
+        memcpy(&word, data, sizeof(WordType));
+        word = FxByteSwap(word);
+        memcpy(data, &word, sizeof(WordType));
+
+        data += sizeof(WordType);
+    }
+}
+
+#ifdef FX_SERIALIZE_X86
+
+/** Returns a shuffle mask that reverses each `WordSize` byte word in a 128 bit lane */
+template <uint32 WordSize>
+static constexpr std::array<uint8, 16> FxMakeSwapMask()
+{
+    std::array<uint8, 16> mask{};
+    for (uint32 i = 0; i < 16; i++) {
+        mask[i] = static_cast<uint8>((i / WordSize) * WordSize + (WordSize - 1 - (i % WordSize)));
+    }
+    return mask;
+}
+
+template <typename WordType>
+FX_TARGET_SSSE3 static void FxSwapArrayBytesSSSE3(uint8* data, uint32 count)
+{
+    static constexpr std::array<uint8, 16> cMask = FxMakeSwapMask<sizeof(WordType)>();
+    constexpr uint32 words_per_vector = 16 / sizeof(WordType);
+
+    const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cMask.data()));
+
+    uint32 i = 0;
+    for (; i + words_per_vector <= count; i += words_per_vector) {
+        __m128i* ptr = reinterpret_cast<__m128i*>(data + i * sizeof(WordType));
+        _mm_storeu_si128(ptr, _mm_shuffle_epi8(_mm_loadu_si128(ptr), mask));
+    }
+
+    FxSwapArrayBytesScalar<WordType>(data + i * sizeof(WordType), count - i);
+}
+
+template <typename WordType>
+FX_TARGET_AVX2 static void FxSwapArrayBytesAVX2(uint8* data, uint32 count)
+{
+    static constexpr std::array<uint8, 16> cMask = FxMakeSwapMask<sizeof(WordType)>();
+    constexpr uint32 words_per_vector = 32 / sizeof(WordType);
+
+    // The shuffle only moves bytes within each 128 bit lane, so the same mask is used for both halves
+    const __m128i lane_mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cMask.data()));
+    const __m256i mask = _mm256_broadcastsi128_si256(lane_mask);
+
+    uint32 i = 0;
+    for (; i + words_per_vector <= count; i += words_per_vector) {
+        __m256i* ptr = reinterpret_cast<__m256i*>(data + i * sizeof(WordType));
+        _mm256_storeu_si256(ptr, _mm256_shuffle_epi8(_mm256_loadu_si256(ptr), mask));
+    }
+
+    FxSwapArrayBytesScalar<WordType>(data + i * sizeof(WordType), count - i);
+}
+
+enum class FxCpuSimdLevel
+{
+    None,
+    SSSE3,
+    AVX2,
+};
+
+static FxCpuSimdLevel FxDetectCpuSimdLevel()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    const int max_leaf = info[0];
+
+    __cpuid(info, 1);
+    const bool has_ssse3 = (info[2] & (1 << 9)) != 0;
+    const bool has_osxsave = (info[2] & (1 << 27)) != 0;
+    const bool has_avx = (info[2] & (1 << 28)) != 0;
+
+    bool has_avx2 = false;
+    if (max_leaf >= 7 && has_osxsave && has_avx && (_xgetbv(0) & 0x6) == 0x6) {
+        __cpuidex(info, 7, 0);
+        has_avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+
+    const bool has_ssse3 = __builtin_cpu_supports("ssse3");
+    const bool has_avx2 = __builtin_cpu_supports("avx2");
+#endif
+
+    if (has_avx2) {
+        return FxCpuSimdLevel::AVX2;
+    }
+    if (has_ssse3) {
+        return FxCpuSimdLevel::SSSE3;
+    }
+    return FxCpuSimdLevel::None;
+}
+
+static FxCpuSimdLevel FxGetCpuSimdLevel()
+{
+    static const FxCpuSimdLevel simd_level = FxDetectCpuSimdLevel();
+    return simd_level;
+}
+
+#endif
+
+template <typename WordType>
+static FxSwapKernel FxSelectSwapKernel()
+{
+#ifdef FX_SERIALIZE_X86
+    switch (FxGetCpuSimdLevel()) {
+    case FxCpuSimdLevel::AVX2:
+        return FxSwapArrayBytesAVX2<WordType>;
+    case FxCpuSimdLevel::SSSE3:
+        return FxSwapArrayBytesSSSE3<WordType>;
+    default:
+        break;
+    }
+#endif
+
+    return FxSwapArrayBytesScalar<WordType>;
+}
+
+// Kernels are selected on the first call rather than during static initialization, so that
+// byte swaps from static initializers in other translation units do not see an unset kernel
+void FxSwapArrayBytes16(uint8* data, uint32 count)
+{
+    static const FxSwapKernel kernel = FxSelectSwapKernel<uint16>();
+    kernel(data, count);
+}
+
+void FxSwapArrayBytes32(uint8* data, uint32 count)
+{
+    static const FxSwapKernel kernel = FxSelectSwapKernel<uint32>();
+    kernel(data, count);
+}
+
+void FxSwapArrayBytes64(uint8* data, uint32 count)
+{
+    static const FxSwapKernel kernel = FxSelectSwapKernel<uint64>();
+    kernel(data, count);
+}
+
+
+/////////////////////////////////////
+// Stream VByte kernels
+/////////////////////////////////////
+
+using FxStreamVByteDecodeKernel = const uint8* (*)(const uint8* control, const uint8* data, const uint8* data_end, uint32 count, uint32* values);
+
+uint8* FxStreamVByteEncode(const uint32* values, uint32 count, uint8* control, uint8* data)
+{
+    for (uint32 i = 0; i < count; i += 4) {
+        uint8 key = 0;
+
+        for (uint32 k = 0; k < 4 && i + k < count; k++) {
+            const uint32 value = values[i + k];
+            const uint32 length = (value < (1U << 8)) ? 1 : (value < (1U << 16)) ? 2 : (value < (1U << 24)) ? 3 : 4;
+
+            key |= static_cast<uint8>((length - 1) << (k * 2));
+
+            // Values are stored little-endian. There is always room for a full word as the
+            // caller reserves four bytes per value.
+            uint32 le_value = value;
+            if constexpr (std::endian::native == std::endian::big) {
+                le_value = FxByteSwap(le_value);
+            }
+            memcpy(data, &le_value, sizeof(uint32));
+
+            data += length;
+        }
+
+        control[i / 4] = key;
+    }
+
+    return data;
+}
+
+static const uint8* FxStreamVByteDecodeScalar(const uint8* control, const uint8* data, const uint8* data_end, uint32 count, uint32* values)
+{
+    for (uint32 i = 0; i < count; i++) {
+        const uint32 length = ((control[i / 4] >> ((i % 4) * 2)) & 0x03) + 1;
+
+        if (data + length > data_end) {
+            return nullptr;
+        }
+
+        uint32 value = 0;
+        for (uint32 b = 0; b < length; b++) {
+            value |= static_cast<uint32>(data[b]) << (b * 8);
+        }
+
+        values[i] = value;
+        data += length;
+    }
+
+    return data;
+}
+
+#ifdef FX_SERIALIZE_X86
+
+struct FxStreamVByteTables
+{
+    /// Shuffle mask that moves the bytes of four values into four 32 bit lanes
+    uint8 Shuffle[256][16];
+
+    /// Total number of data bytes used by the four values
+    uint8 Length[256];
+};
+
+static constexpr FxStreamVByteTables FxMakeStreamVByteTables()
+{
+    FxStreamVByteTables tables{};
+
+    for (uint32 key = 0; key < 256; key++) {
+        uint8 offset = 0;
+
+        for (uint32 k = 0; k < 4; k++) {
+            const uint8 length = ((key >> (k * 2)) & 0x03) + 1;
+
+            for (uint8 b = 0; b < 4; b++) {
+                // 0x80 clears the destination byte
+                tables.Shuffle[key][k * 4 + b] = (b < length) ? static_cast<uint8>(offset + b) : 0x80;
+            }
+
+            offset += length;
+        }
+
+        tables.Length[key] = offset;
+    }
+
+    return tables;
+}
+
+static constexpr FxStreamVByteTables sStreamVByteTables = FxMakeStreamVByteTables();
+
+FX_TARGET_SSSE3 static const uint8* FxStreamVByteDecodeSSSE3(const uint8* control, const uint8* data, const uint8* data_end, uint32 count, uint32* values)
+{
+    uint32 i = 0;
+
+    // Each group loads a full 16 bytes, so the last few groups are decoded with the scalar path
+    for (; i + 4 <= count && data + 16 <= data_end; i += 4) {
+        const uint8 key = control[i / 4];
+
+        const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+        const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sStreamVByteTables.Shuffle[key]));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(values + i), _mm_shuffle_epi8(input, shuffle));
+
+        data += sStreamVByteTables.Length[key];
+    }
+
+    return FxStreamVByteDecodeScalar(control + i / 4, data, data_end, count - i, values + i);
+}
+
+#endif
+
+static FxStreamVByteDecodeKernel FxSelectStreamVByteDecodeKernel()
+{
+#ifdef FX_SERIALIZE_X86
+    if (FxGetCpuSimdLevel() != FxCpuSimdLevel::None) {
+        return FxStreamVByteDecodeSSSE3;
+    }
+#endif
+
+    return FxStreamVByteDecodeScalar;
+}
+
+const uint8* FxStreamVByteDecode(const uint8* control, const uint8* data, const uint8* data_end, uint32 count, uint32* values)
 {
-    uint32 str_size = reader.DataSection.Read16();
+    // Selected on the first call for the same reason as the byte swap kernels
+    static const FxStreamVByteDecodeKernel kernel = FxSelectStreamVByteDecodeKernel();
 
-    value->resize(str_size + 1);
-    reader.DataSection.ReadBuffer(str_size + 1, reinterpret_cast<uint8*>(value->data()));
+    return kernel(control, data, data_end, count, values);
 }
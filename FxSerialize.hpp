@@ -8,9 +8,18 @@
 
 #include "FxTypes.hpp"
 #include "FxHash.hpp"
+#include "FxUtil.hpp"
 
+#include <span>
+#include <array>
+#include <algorithm>
 #include <vector>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
 #include <cstdio>
+#include <cstring>
 #include <cassert>
 #include <iostream>
 
@@ -18,10 +27,12 @@
 #ifdef FX_USE_MEMPOOL
 #include "FxMemPool.hpp"
 #define FX_ALLOC_MEM(type_, size_) FxMemPool::Alloc<type_>(size_)
+#define FX_REALLOC_MEM(type_, ptr_, size_) FxMemPool::Realloc<type_>(ptr_, size_)
 #define FX_FREE_MEM(ptr_) FxMemPool::Free(ptr_)
 #else
 #include <cstdlib>
 #define FX_ALLOC_MEM(type_, size_) static_cast<type_*>(malloc(size_))
+#define FX_REALLOC_MEM(type_, ptr_, size_) static_cast<type_*>(realloc(ptr_, size_))
 #define FX_FREE_MEM(ptr_) free(ptr_)
 #endif
 
@@ -34,10 +45,17 @@
 *
 *       - The main "Data" section immediately follows the types and contains an entry
 *         per serialized value. Member structures will be serialized and written inline
-*         and will be treated like another entry inside of the current one.
+*         and will be treated like another entry inside of the current one. In compact mode (0x04)
+*         member structures are written as only their members, without an entry header or footer,
+*         and only top level entries have a header and footer.
+*
+*       - All values are stored in the byte order of the machine that wrote the file,
+*         which is recorded in the header flags. Readers on a machine with the same
+*         byte order read values as-is, and only foreign readers swap bytes.
 *
     +-------------- File Header -------------------------------------------+
     | FXSD       | int8[4] | File signature, start of types section
+    | 00         | uint8   | Flags (0x01 = LE, 0x02 = varints, 0x04 = compact, 0x08 = dir)
     | 0000 0000  | uint32  | Length of types section
     +----------------------------------------------------------------------+
 
@@ -67,6 +85,7 @@
     | 0B         | uint8   | Data entry start
     | 0000       | uint16  | Type ID
     | 0000 0000  | uint32  | Name Hash (name checks are disabled if zero)
+    | 0000 0000  | uint32  | Length of the member data in bytes
     |
     | ... Data for all members ...
     |
@@ -77,29 +96,96 @@
     | ...                                                                  |
 
     ... Remaining Data Entries ...
+
+    +-------------- Directory Section (flag 0x08) -------------------------+
+    | .DIR       | int8[4] | Start of directory section
+    | 0000 0000  | uint32  | Number of directory entries
+    | 0000 0000  | uint32  | Name hash of a top level entry, sorted by name hash
+    | 0000 0000  | uint32  | Offset of the entry in the data section
+    |
+    | ... Remaining directory entries ...
+    +----------------------------------------------------------------------+
 */
 
 
+/**
+ * Declares a fixed type id for a serializable struct, used alongside FX_SERIALIZABLE_MEMBERS. Declared ids
+ * are stable across compilers and renames, and can be used to resolve a collision between two generated ids.
+ * The id only applies to the struct that declares it, structs derived from it get their own id.
+ */
+#define FX_SERIALIZABLE_TYPE_ID(id_) \
+    static constexpr uint16 SerializerTypeId_ = id_; \
+    auto SerializerTypeIdOwner_() const -> std::remove_cvref_t<decltype(*this)>*
+
+template <typename T>
+concept C_HasDeclaredTypeId = requires(const T& value)
+{
+    { T::SerializerTypeId_ } -> std::convertible_to<uint16>;
+
+    // Members are inherited, so check that the id was declared in T and not in a base struct
+    { value.SerializerTypeIdOwner_() } -> std::same_as<T*>;
+};
+
 class FxSerializeUtil
 {
 public:
-    static inline uint16 SerializeTypeIdCount = 0;
-
-    /** Generates a unique ID for a type `T` */
+    /**
+     * Returns the id for a type `T`. The id is computed at compile time from the name of the type,
+     * so it is the same across runs and builds with the same compiler. Type names are spelled
+     * differently by other compilers and standard libraries, so files that are shared between
+     * toolchains should declare a fixed id on each struct with FX_SERIALIZABLE_TYPE_ID.
+     */
     template <typename T>
-    static const uint16 GetTypeId()
+    static constexpr uint16 GetTypeId()
     {
         return GetTypeId_<std::remove_const_t<std::remove_reference_t<T>>>();
     }
 
+    /** Returns the name of the type `T` as written by the compiler, for example "TestStructA" or "int" */
     template <typename T>
-    static const uint16 GetTypeId_()
+    static constexpr std::string_view GetTypeName()
     {
-        static uint16 tid = ++SerializeTypeIdCount;
-        return tid;
+#if defined(_MSC_VER) && !defined(__clang__)
+        // class std::basic_string_view<...> __cdecl FxSerializeUtil::GetTypeName<struct TestStructA>(void)
+        constexpr std::string_view signature = __FUNCSIG__;
+        constexpr size_t start = signature.find("GetTypeName<") + sizeof("GetTypeName<") - 1;
+        constexpr size_t end = signature.rfind(">(void)");
+#else
+        // GCC:   ... GetTypeName() [with T = TestStructA; std::string_view = ...]
+        // Clang: ... GetTypeName() [T = TestStructA]
+        constexpr std::string_view signature = __PRETTY_FUNCTION__;
+        constexpr size_t start = signature.find("T = ") + sizeof("T = ") - 1;
+        constexpr size_t end = (signature.find("; ", start) != std::string_view::npos) ? signature.find("; ", start) : signature.rfind(']');
+#endif
+        std::string_view name = signature.substr(start, end - start);
+
+        // MSVC prefixes class types with their keyword
+        for (std::string_view prefix : { "struct ", "class ", "enum ", "union " }) {
+            if (name.starts_with(prefix)) {
+                name.remove_prefix(prefix.size());
+            }
+        }
+
+        return name;
     }
 
 private:
+    template <typename T>
+    static constexpr uint16 GetTypeId_()
+    {
+        if constexpr (C_HasDeclaredTypeId<T>) {
+            return T::SerializerTypeId_;
+        }
+        else {
+            constexpr std::string_view name = GetTypeName<T>();
+            constexpr FxHash hash = FxHashStr(name.data(), static_cast<uint32>(name.size()));
+
+            // Fold the hash down to 16 bits, avoiding zero so that it can be used as an empty id
+            constexpr uint16 id = static_cast<uint16>(hash ^ (hash >> 16));
+
+            return (id == 0) ? 1 : id;
+        }
+    }
 };
 
 
@@ -115,20 +201,242 @@ concept C_IsSerializable = requires(T t, FxSerializerIO& writer)
 template <typename T, typename... U>
 concept C_IsAnyOf = (std::same_as<T, U> || ...);
 
+/** Integers, floating point values, and enums that are written with a FxPrimitiveCodec */
 template <typename T>
-concept C_IsByteType = std::is_convertible_v<T, uint8>;
+concept C_IsPrimitive = (std::is_arithmetic_v<T> || std::is_enum_v<T>) && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
 
 template <typename T>
 concept C_IsIntType = std::is_convertible_v<T, int32>;
 
+/** Integer types that are written as LEB128 values when variable length integers are enabled */
+template <typename T>
+concept C_IsVarIntType = std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) > 1;
+
+/**
+ * Describes contiguous containers that can be serialized as a length followed by each element.
+ */
+template <typename T>
+struct FxContainerTraits
+{
+    static constexpr bool IsContainer = false;
+};
+
+template <typename ElementT, typename AllocatorT>
+struct FxContainerTraits<std::vector<ElementT, AllocatorT>>
+{
+    static constexpr bool IsContainer = !std::is_same_v<ElementT, bool>;
+    static constexpr bool IsResizable = true;
+
+    using ElementType = ElementT;
+};
+
+template <typename ElementT, size_t N>
+struct FxContainerTraits<std::array<ElementT, N>>
+{
+    static constexpr bool IsContainer = true;
+    static constexpr bool IsResizable = false;
+
+    using ElementType = ElementT;
+};
+
+template <typename ElementT, size_t N>
+struct FxContainerTraits<ElementT[N]>
+{
+    static constexpr bool IsContainer = true;
+    static constexpr bool IsResizable = false;
+
+    using ElementType = ElementT;
+};
+
+template <typename T>
+concept C_IsContainer = FxContainerTraits<T>::IsContainer;
+
+/**
+ * A buffer that has been released from a section. The memory is freed when the buffer is destroyed,
+ * unless ownership is passed on with std::move or adopted by another section.
+ */
+struct FxSerializerBuffer
+{
+    FxSerializerBuffer() = default;
+
+    FxSerializerBuffer(uint8* data, uint32 size, uint32 capacity)
+        : Data(data), Size(size), Capacity(capacity)
+    {
+    }
+
+    FxSerializerBuffer(const FxSerializerBuffer& other) = delete;
+    FxSerializerBuffer& operator = (const FxSerializerBuffer& other) = delete;
+
+    FxSerializerBuffer(FxSerializerBuffer&& other) noexcept
+        : Data(std::exchange(other.Data, nullptr)),
+          Size(std::exchange(other.Size, 0)),
+          Capacity(std::exchange(other.Capacity, 0))
+    {
+    }
+
+    FxSerializerBuffer& operator = (FxSerializerBuffer&& other) noexcept
+    {
+        if (this != &other) {
+            FX_FREE_MEM(Data);
+
+            Data = std::exchange(other.Data, nullptr);
+            Size = std::exchange(other.Size, 0);
+            Capacity = std::exchange(other.Capacity, 0);
+        }
+        return *this;
+    }
+
+    ~FxSerializerBuffer()
+    {
+        FX_FREE_MEM(Data);
+    }
+
+    uint8* Data = nullptr;
+
+    /// Number of bytes that were written to the buffer
+    uint32 Size = 0;
+
+    /// Allocated size of the buffer
+    uint32 Capacity = 0;
+};
+
 class FxSerializerBaseSection
 {
 public:
+    /// Smallest capacity that a section will grow to on its first write
+    static constexpr uint32 MinimumCapacity = 256;
+
+public:
+    FxSerializerBaseSection() = default;
+
+    FxSerializerBaseSection(const FxSerializerBaseSection& other) = delete;
+    FxSerializerBaseSection& operator = (const FxSerializerBaseSection& other) = delete;
+
+    FxSerializerBaseSection(FxSerializerBaseSection&& other) noexcept
+    {
+        MoveFrom(other);
+    }
+
+    FxSerializerBaseSection& operator = (FxSerializerBaseSection&& other) noexcept
+    {
+        if (this != &other) {
+            FreeData();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    /**
+     * Takes ownership of the written buffer, leaving the section empty. This allows a finished
+     * buffer to be passed to another owner without copying it. If the section is using an external
+     * buffer, the written data is copied into a new buffer as the section does not own the memory.
+     */
+    FxSerializerBuffer Release()
+    {
+        if (IsExternal) {
+            uint8* data_copy = FX_ALLOC_MEM(uint8, Index);
+            memcpy(data_copy, Data, Index);
+
+            FxSerializerBuffer buffer(data_copy, Index, Index);
+            FreeData();
+
+            Index = 0;
+            Size = 0;
+
+            return buffer;
+        }
+
+        FxSerializerBuffer buffer(Data, Index, Capacity);
+
+        Data = nullptr;
+        Index = 0;
+        Size = 0;
+        Capacity = 0;
+
+        return buffer;
+    }
+
+    /**
+     * Replaces the section's buffer with `buffer`, freeing the current one. The section is rewound
+     * and sized to the written length of the buffer, so reads stop at the end of the written data.
+     * Writing past that length grows the buffer as usual.
+     */
+    void Adopt(FxSerializerBuffer&& buffer)
+    {
+        FreeData();
+
+        Data = std::exchange(buffer.Data, nullptr);
+        Size = std::exchange(buffer.Size, 0);
+        Capacity = std::max(std::exchange(buffer.Capacity, 0), Size);
+        Index = 0;
+    }
+
+    /**
+     * Allocates the buffer with exactly `buffer_size` bytes and rewinds the section. Sections
+     * are otherwise allocated on their first write, so this is only needed to size a buffer up front.
+     */
     void Create(uint32 buffer_size);
 
+    /**
+     * Rewinds the section and limits reads to the first `length` bytes, allocating if the buffer is too small.
+     * The capacity is kept, so anything left past `length` from a previous use cannot be read.
+     */
+    void PrepareForRead(uint32 length);
+
+    /** Rewinds the section so that it can be written to again, keeping the allocated buffer */
+    void Reset()
+    {
+        Index = 0;
+        SwapBytes = false;
+    }
+
+    /**
+     * Points the section at memory owned by the caller, such as a stack array or a slot in a shared memory
+     * ring. Values are written directly into `buffer`, and the section never frees it. If more than
+     * `buffer.size()` bytes are written, the section moves the data to its own allocation, which can be
+     * checked with `IsExternal`.
+     */
+    void SetExternalBuffer(std::span<uint8> buffer)
+    {
+        FreeData();
+
+        Data = buffer.data();
+        Size = static_cast<uint32>(buffer.size());
+        Capacity = Size;
+        Index = 0;
+        IsExternal = true;
+    }
+
+    /**
+     * Points the section at read only memory owned by the caller, such as a mapped file. The section
+     * never writes to `buffer`, the first write copies the data into a buffer owned by the section.
+     */
+    void SetReadOnlyBuffer(std::span<const uint8> buffer)
+    {
+        SetExternalBuffer(std::span<uint8>(const_cast<uint8*>(buffer.data()), buffer.size()));
+        IsReadOnly = true;
+    }
+
+    /**
+     * Ensures that `size` more bytes can be written at `Index`, growing the buffer if needed.
+     */
+    inline void Reserve(uint64 size)
+    {
+        if (static_cast<uint64>(Index) + size > Size || IsReadOnly) [[unlikely]] {
+            Grow(static_cast<uint64>(Index) + size);
+        }
+    }
+
+    /**
+     * Reallocates the buffer to hold at least `required_size` bytes. The capacity is doubled
+     * on each growth so that appends stay amortized O(1). If the buffer is already large enough,
+     * such as after a read limited the size, the size is extended to the capacity instead.
+     */
+    void Grow(uint64 required_size);
+
     ~FxSerializerBaseSection()
     {
-        FX_FREE_MEM(Data);
+        FreeData();
     }
 
     ////////////////////////
@@ -137,27 +445,53 @@ public:
 
     inline void Write8(uint8 value)
     {
-        assert(Index < Size);
+        Reserve(1);
         Data[Index++] = value;
     }
 
     inline void Write16(uint16 value16)
     {
-        assert(Index + 2 <= Size);
-        Data[Index++] = static_cast<uint8>((value16 >> 8));
-        Data[Index++] = static_cast<uint8>(value16);
+        WriteWord(value16);
     }
 
     inline void Write32(uint32 value32)
     {
-        Write16(static_cast<uint16>(value32 >> 16));
-        Write16(static_cast<uint16>(value32));
+        WriteWord(value32);
+    }
+
+    inline void Write64(uint64 value64)
+    {
+        WriteWord(value64);
+    }
+
+    /** Writes an unsigned LEB128 value, using 7 bits per byte */
+    inline void WriteVarUint(uint64 value)
+    {
+        Reserve(10);
+
+        while (value >= 0x80) {
+            Data[Index++] = static_cast<uint8>(value) | 0x80;
+            value >>= 7;
+        }
+        Data[Index++] = static_cast<uint8>(value);
+    }
+
+    /** Writes an integer as LEB128, using zigzag encoding for signed values */
+    template <typename T> requires C_IsVarIntType<T>
+    inline void WriteVarInt(T value)
+    {
+        if constexpr (std::is_signed_v<T>) {
+            WriteVarUint(FxZigZagEncode(value));
+        }
+        else {
+            WriteVarUint(value);
+        }
     }
 
     /** Writes a buffer of bytes to the section */
     inline void WriteBuffer(uint32 size, const uint8* data)
     {
-        assert(Index + size <= Size);
+        Reserve(size);
 
         memcpy(Data + Index, data, size);
         Index += size;
@@ -167,44 +501,173 @@ public:
     // Read functions
     ////////////////////////
 
+    // Reads past the end of the section return zero and leave the index where it is, so that a
+    // malformed entry cannot read outside of the buffer.
+
     uint8 Read8()
     {
-        assert(Index + 1 <= Size);
+        if (Index >= Size) [[unlikely]] {
+            return 0;
+        }
 
         return Data[(Index)++];
     }
 
     uint16 Read16()
     {
-        assert(Index + 2 <= Size);
+        return ReadWord<uint16>();
+    }
 
-        const uint16 hi = (static_cast<uint16>(Data[Index++])) << 8;
-        const uint16 lo = Data[Index++];
+    uint32 Read32()
+    {
+        return ReadWord<uint32>();
+    }
 
-        return hi | lo;
+    uint64 Read64()
+    {
+        return ReadWord<uint64>();
     }
 
-    uint32 Read32()
+    uint64 ReadVarUint()
+    {
+        uint64 value = 0;
+
+        for (uint32 shift = 0; shift < 64 && Index < Size; shift += 7) {
+            const uint8 byte = Data[Index++];
+            value |= static_cast<uint64>(byte & 0x7F) << shift;
+
+            if (!(byte & 0x80)) {
+                break;
+            }
+        }
+
+        return value;
+    }
+
+    template <typename T> requires C_IsVarIntType<T>
+    T ReadVarInt()
     {
-        return (static_cast<uint32>(Read16()) << 16 | static_cast<uint32>(Read16()));
+        using UnsignedType = std::make_unsigned_t<T>;
+
+        const UnsignedType value = static_cast<UnsignedType>(ReadVarUint());
+
+        if constexpr (std::is_signed_v<T>) {
+            return FxZigZagDecode(value);
+        }
+        else {
+            return value;
+        }
     }
 
     inline void ReadBuffer(uint32 size, uint8* buffer)
     {
-        if (Index + size > Size) {
+        if (static_cast<uint64>(Index) + size > Size) {
             printf("ReadBuffer outside of buffer size!");
             return;
         }
-        memcpy(Data + Index, buffer, size);
+        memcpy(buffer, Data + Index, size);
 
         Index += size;
     }
 
+    /**
+     * Returns a view of the next `size` bytes in the section without copying them. The view points into
+     * the section, so it is only valid until the section is next written to, reset, released or freed.
+     */
+    inline std::span<const uint8> ReadBufferView(uint32 size)
+    {
+        if (static_cast<uint64>(Index) + size > Size) {
+            printf("ReadBufferView outside of buffer size!");
+            return {};
+        }
+
+        std::span<const uint8> view(Data + Index, size);
+        Index += size;
+
+        return view;
+    }
+
+private:
+    /** Writes a 16, 32, or 64 bit word in native byte order with a single bounds check and store */
+    template <typename T>
+    inline void WriteWord(T value)
+    {
+        Reserve(sizeof(T));
+
+        memcpy(Data + Index, &value, sizeof(T));
+
+        Index += sizeof(T);
+    }
+
+    /** Reads a 16, 32, or 64 bit word with a single bounds check and load */
+    template <typename T>
+    inline T ReadWord()
+    {
+        if (static_cast<uint64>(Index) + sizeof(T) > Size) [[unlikely]] {
+            return 0;
+        }
+
+        T value;
+        memcpy(&value, Data + Index, sizeof(T));
+
+        Index += sizeof(T);
+
+        if (SwapBytes) [[unlikely]] {
+            return FxByteSwap(value);
+        }
+        return value;
+    }
+
+    void MoveFrom(FxSerializerBaseSection& other)
+    {
+        Data = std::exchange(other.Data, nullptr);
+        Index = std::exchange(other.Index, 0);
+        Size = std::exchange(other.Size, 0);
+        Capacity = std::exchange(other.Capacity, 0);
+        InitialCapacity = other.InitialCapacity;
+        SwapBytes = std::exchange(other.SwapBytes, false);
+        IsExternal = std::exchange(other.IsExternal, false);
+        IsReadOnly = std::exchange(other.IsReadOnly, false);
+    }
+
+    /** Frees the buffer if it is owned by the section */
+    void FreeData()
+    {
+        if (!IsExternal) {
+            FX_FREE_MEM(Data);
+        }
+
+        Data = nullptr;
+        Capacity = 0;
+        IsExternal = false;
+        IsReadOnly = false;
+    }
+
+    /** Resizes the buffer, moving external data into a buffer owned by the section */
+    uint8* ReallocData(uint32 new_size);
+
 
 public:
     uint8* Data = nullptr;
     uint32 Index = 0;
+
+    /// Number of bytes that can be used before the buffer grows. After a load, this is the length of the loaded section.
     uint32 Size = 0;
+
+    /// Allocated size of `Data` in bytes
+    uint32 Capacity = 0;
+
+    /// Capacity that the buffer is allocated with on the first write
+    uint32 InitialCapacity = MinimumCapacity;
+
+    /// Set when the section was written on a machine with a different byte order
+    bool SwapBytes = false;
+
+    /// Set when `Data` points to memory owned by the caller, see SetExternalBuffer
+    bool IsExternal = false;
+
+    /// Set when `Data` points to memory that cannot be written to, see SetReadOnlyBuffer
+    bool IsReadOnly = false;
 };
 
 struct FxSerializerDataSection : public FxSerializerBaseSection
@@ -215,19 +678,122 @@ struct FxSerializerDataSection : public FxSerializerBaseSection
     /// Data section end identifier
     static const uint8 DataIdentFooter = 0xB0;
 
-    void WriteHeader(uint16 type_id, FxHash name_hash)
+    /// Integers are written as variable length LEB128 values
+    bool UseVarInts = false;
+
+    /// Nested structs are written as their members only, without an entry header or footer
+    bool UseCompactStructs = false;
+
+    /** Writes a string as its length, its characters and a null terminator */
+    void WriteString(std::string_view str)
+    {
+        const uint32 str_size = static_cast<uint32>(str.size());
+
+        Write32(str_size);
+        WriteBuffer(str_size, reinterpret_cast<const uint8*>(str.data()));
+        Write8(0);
+    }
+
+    /**
+     * Reads a string written with WriteString without copying it. The view points into the section,
+     * so it is only valid until the section is next written to, reset, released or freed.
+     */
+    std::string_view ReadStringView()
+    {
+        const uint32 str_size = Read32();
+
+        std::span<const uint8> chars = ReadBufferView(str_size);
+
+        // The length was corrupt or the section is truncated, leave the terminator alone
+        if (chars.size() != str_size || Index + 1 > Size) {
+            return {};
+        }
+
+        // Skip the null terminator
+        Read8();
+
+        return std::string_view(reinterpret_cast<const char*>(chars.data()), chars.size());
+    }
+
+    /**
+     * Reads a byte array written from a std::vector<uint8> or std::span<const uint8> without copying it.
+     * The view has the same lifetime as the views returned from ReadBufferView.
+     */
+    std::span<const uint8> ReadBytesView()
+    {
+        const uint32 count = Read32();
+
+        return ReadBufferView(count);
+    }
+
+    /** Size of an entry header: start identifier, type id, name hash and length */
+    static constexpr uint32 EntryHeaderSize = 11;
+
+    /**
+     * Writes the header for an entry. The length is not known until the members are written, so
+     * this returns the offset of the length to pass to WriteFooter.
+     */
+    uint32 WriteHeader(uint16 type_id, FxHash name_hash)
     {
         Write8(DataIdentHeader);
 
         Write16(type_id);
         Write32(name_hash);
+
+        const uint32 length_offset = Index;
+        Write32(0);
+
+        return length_offset;
     }
 
-    void WriteFooter()
+    /** Writes the footer for an entry and fills in the length of the entry that was started at `length_offset` */
+    void WriteFooter(uint32 length_offset)
     {
+        const uint32 length = Index - (length_offset + sizeof(uint32));
+        memcpy(Data + length_offset, &length, sizeof(uint32));
+
         Write8(DataIdentFooter);
     }
 
+    /**
+     * Skips over the entry at the current index without reading its members. Returns false if there
+     * is no valid entry at the current index.
+     */
+    bool SkipEntry()
+    {
+        if (Index + EntryHeaderSize > Size) {
+            return false;
+        }
+
+        const uint32 start_index = Index;
+
+        if (Read8() != DataIdentHeader) {
+            Index = start_index;
+            return false;
+        }
+
+        Read16(); // type id
+        Read32(); // name hash
+
+        const uint32 length = Read32();
+
+        if (static_cast<uint64>(Index) + length + sizeof(uint8) > Size) {
+            printf("Entry length %u runs past the end of the section!\n", length);
+            Index = start_index;
+            return false;
+        }
+
+        Index += length;
+
+        if (Read8() != DataIdentFooter) {
+            printf("Footer is incorrect!\n");
+            Index = start_index;
+            return false;
+        }
+
+        return true;
+    }
+
     void PrintFormattedData(uint32 count)
     {
         const int width = 20;
@@ -255,98 +821,352 @@ struct FxSerializerDataSection : public FxSerializerBaseSection
 };
 
 
-struct FxSerializedType
+///////////////////////////////
+// Type Records
+///////////////////////////////
+
+template <typename... Types>
+struct FxTypeList
 {
-    uint16 Id;
-    uint16 Size;
-    std::vector<FxSerializedType> Members;
 };
 
-class FxSerializerTypeSection : public FxSerializerBaseSection
+/** Converts the tuple of member pointers from FX_SERIALIZABLE_MEMBERS to a list of the member types */
+template <typename MemberPtrsTuple>
+struct FxMemberTypeList;
+
+template <typename... Types>
+struct FxMemberTypeList<std::tuple<Types*...>>
 {
-    struct TypeEntry
-    {
-        uint16 Id;
-        uint32 Offset;
-    };
+    using Type = FxTypeList<std::remove_cv_t<Types>...>;
+};
 
-    /// Type section start identifier
-    static const uint8 TypeIdentHeader = 0xEF;
+/**
+ * Describes the type section entry for `T`: the size written for the type, and the types it
+ * references as members. Primitives and other types are written with no members.
+ */
+template <typename T>
+struct FxTypeRecordTraits
+{
+    using Members = FxTypeList<>;
+    static constexpr uint16 Size = static_cast<uint16>(sizeof(T));
+};
 
-    /// Type section end identifier
-    static const uint8 TypeIdentFooter = 0xBE;
+template <typename T> requires C_IsSerializable<T>
+struct FxTypeRecordTraits<T>
+{
+    using Members = typename FxMemberTypeList<typename T::SerializerMembers_>::Type;
+    static constexpr uint16 Size = static_cast<uint16>(sizeof(T));
+};
 
-public:
-    template <typename T>
-    void WriteTypeForTypeId(FxSerializerIO& writer)
-    {
-        const uint16 type_id = FxSerializeUtil::GetTypeId<T>();
+/** Containers are variable length, so they are written with a size of zero and the element type as their only member */
+template <typename T> requires C_IsContainer<T>
+struct FxTypeRecordTraits<T>
+{
+    using Members = FxTypeList<std::remove_cv_t<typename FxContainerTraits<T>::ElementType>>;
+    static constexpr uint16 Size = 0;
+};
 
-        if (IsTypePreviouslyWritten(type_id)) {
-            return;
-        }
+template <typename List, typename T>
+struct FxTypeListContains;
 
-        if constexpr (C_IsSerializable<T>) {
-            T t_instance{ };
-            t_instance.WriteTypeTo(writer);
-        }
-        else {
-            WriteTypeWithoutChecks(type_id, sizeof(T));
-        }
+template <typename... Types, typename T>
+struct FxTypeListContains<FxTypeList<Types...>, T>
+{
+    static constexpr bool Value = (std::is_same_v<Types, T> || ...);
+};
 
-    }
+template <typename List, typename T>
+struct FxTypeListAppend;
+
+template <typename... Types, typename T>
+struct FxTypeListAppend<FxTypeList<Types...>, T>
+{
+    using Type = FxTypeList<Types..., T>;
+};
 
+template <typename Visited, typename T>
+struct FxCollectTypes;
 
-    template <typename... Types>
-    void WriteTypeWithoutChecks(uint16 type_id, uint16 type_size, Types&&... args)
+template <typename Visited, typename MemberList>
+struct FxCollectMemberTypes;
+
+template <typename Visited>
+struct FxCollectMemberTypes<Visited, FxTypeList<>>
+{
+    using Type = Visited;
+};
+
+template <typename Visited, typename First, typename... Rest>
+struct FxCollectMemberTypes<Visited, FxTypeList<First, Rest...>>
+{
+    using Type = typename FxCollectMemberTypes<typename FxCollectTypes<Visited, First>::Type, FxTypeList<Rest...>>::Type;
+};
+
+/**
+ * Appends `T` and every type it references to `Visited`, skipping types that are already in the list.
+ * Members come before the types that reference them, the same order they are registered in.
+ */
+template <typename Visited, typename T>
+struct FxCollectTypes
+{
+private:
+    using WithMembers = typename FxCollectMemberTypes<Visited, typename FxTypeRecordTraits<T>::Members>::Type;
+
+public:
+    using Type = std::conditional_t<
+        FxTypeListContains<Visited, T>::Value,
+        Visited,
+        typename FxTypeListAppend<WithMembers, T>::Type
+    >;
+};
+
+
+/**
+ * A type read from the type section. Members are stored in a list shared by all types in the
+ * section, use FxSerializerTypeSection::GetMemberType to look them up.
+ */
+struct FxSerializedType
+{
+    uint16 Id = 0;
+    uint16 Size = 0;
+
+    /// Offset of the type entry in the type section
+    uint32 Offset = 0;
+
+    /// Range of this type's members in the section's member list
+    uint32 MembersStart = 0;
+    uint32 MembersCount = 0;
+};
+
+class FxSerializerTypeSection : public FxSerializerBaseSection
+{
+    struct TypeEntry
     {
-        if (IsTypePreviouslyWritten(type_id)) {
-            return;
-        }
+        uint16 Id;
+        uint32 Offset;
 
-        printf("Writing Type %d\n", type_id);
-        const uint32 start_offset = Index;
+        /// The compile time entry this type was written from, or nullptr if it has not been checked against one yet
+        const uint8* Record = nullptr;
+    };
 
-        // Write start identifier
-        Write8(TypeIdentHeader);
+    /// Type section start identifier
+    static const uint8 TypeIdentHeader = 0xEF;
 
-        // Write the type id
-        Write16(type_id);
+    /// Type section end identifier
+    static const uint8 TypeIdentFooter = 0xBE;
+
+    /// Size of a type entry without any members: header, id, size, member count and footer
+    static constexpr uint32 TypeRecordBaseSize = 7;
+
+    /// Size of each member in a type entry: size and id
+    static constexpr uint32 TypeRecordMemberSize = 4;
 
-        // Write the size of the type
-        Write16(type_size);
+    /** Builds the type entry for `T` as it is laid out in the section, in native byte order */
+    template <typename T, typename... MemberTypes>
+    static constexpr auto MakeTypeRecord(FxTypeList<MemberTypes...>)
+    {
+        static_assert(sizeof...(MemberTypes) <= UINT8_MAX, "Too many members in serializable type");
+
+        std::array<uint8, TypeRecordBaseSize + TypeRecordMemberSize * sizeof...(MemberTypes)> record{ };
+        uint32 index = 0;
 
-        // Number of member primitives
-        Write8(sizeof...(args));
+        auto write8 = [&](uint8 value) {
+            record[index++] = value;
+        };
 
-        auto write_member_func = [&] (uint16 type_id, uint16 size) {
-            Write16(size);
-            Write16(type_id);
+        auto write16 = [&](uint16 value) {
+            if constexpr (std::endian::native == std::endian::little) {
+                write8(static_cast<uint8>(value));
+                write8(static_cast<uint8>(value >> 8));
+            }
+            else {
+                write8(static_cast<uint8>(value >> 8));
+                write8(static_cast<uint8>(value));
+            }
         };
 
-        // Write all of the types we reference (each type id)
-        (write_member_func(FxSerializeUtil::GetTypeId<decltype(args)>(), sizeof(decltype(args))), ...);
+        write8(TypeIdentHeader);
+        write16(FxSerializeUtil::GetTypeId<T>());
+        write16(FxTypeRecordTraits<T>::Size);
+        write8(static_cast<uint8>(sizeof...(MemberTypes)));
+
+        ((write16(static_cast<uint16>(sizeof(MemberTypes))), write16(FxSerializeUtil::GetTypeId<MemberTypes>())), ...);
 
-        // Write end
-        Write8(TypeIdentFooter);
+        write8(TypeIdentFooter);
 
-        mRegisteredTypeIds.emplace_back(TypeEntry{ type_id, start_offset });
+        return record;
     }
 
-    /** Writes out and each member inside it to the type section. */
+    template <typename T>
+    static constexpr auto TypeRecord = MakeTypeRecord<T>(typename FxTypeRecordTraits<T>::Members{ });
+
+    /** The entries for a list of types, concatenated in order, along with the id and offset of each entry */
+    template <typename List>
+    struct TypeBlock;
+
     template <typename... Types>
-    void WriteTypeAndMembers(FxSerializerIO& writer, uint16 type_id, uint16 type_size, Types&&... args)
+    struct TypeBlock<FxTypeList<Types...>>
     {
-        if (IsTypePreviouslyWritten(type_id)) {
-            return;
+        static constexpr std::array<uint16, sizeof...(Types)> Ids = { FxSerializeUtil::GetTypeId<Types>()... };
+
+        static constexpr std::array<const uint8*, sizeof...(Types)> Records = { TypeRecord<Types>.data()... };
+
+        static constexpr bool HasUniqueIds = [] {
+            for (size_t i = 0; i < Ids.size(); i++) {
+                for (size_t j = i + 1; j < Ids.size(); j++) {
+                    if (Ids[i] == Ids[j]) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }();
+
+        static_assert(HasUniqueIds, "Two serializable types share a type id, declare a unique id for one of them with FX_SERIALIZABLE_TYPE_ID");
+
+        static constexpr std::array<uint32, sizeof...(Types)> Offsets = [] {
+            std::array<uint32, sizeof...(Types)> offsets{ };
+            uint32 offset = 0;
+            uint32 index = 0;
+
+            ((offsets[index++] = offset, offset += static_cast<uint32>(TypeRecord<Types>.size())), ...);
+
+            return offsets;
+        }();
+
+        static constexpr auto Bytes = [] {
+            std::array<uint8, (TypeRecord<Types>.size() + ... + 0)> bytes{ };
+            uint32 offset = 0;
+
+            auto append = [&](const auto& record) {
+                for (uint8 value : record) {
+                    bytes[offset++] = value;
+                }
+            };
+
+            (append(TypeRecord<Types>), ...);
+
+            return bytes;
+        }();
+    };
+
+public:
+    /**
+     * Writes the type entry for `T` and every type it references, if they have not been written
+     * already. The entries are generated at compile time, so registering a type never constructs it.
+     * Returns false if `T` or a type it references has the same id as a different type in the section.
+     */
+    template <typename T>
+    bool WriteTypeForTypeId()
+    {
+        using BaseT = std::remove_cvref_t<T>;
+
+        if (TypeEntry* entry = FindRegisteredType(FxSerializeUtil::GetTypeId<BaseT>())) {
+            if (entry->Record == TypeRecord<BaseT>.data()) {
+                return true;
+            }
+
+            // The id is registered by another block or a loaded section, make sure it is the same type
+            return CheckRegisteredType(*entry, TypeRecord<BaseT>.data(), static_cast<uint32>(TypeRecord<BaseT>.size()), FxSerializeUtil::GetTypeName<BaseT>());
+        }
+
+        using Block = TypeBlock<typename FxCollectTypes<FxTypeList<>, BaseT>::Type>;
+
+        bool any_written = false;
+        for (uint16 type_id : Block::Ids) {
+            any_written |= IsTypePreviouslyWritten(type_id);
+        }
+
+        if (!any_written) {
+            // None of the types are in the section yet, copy all of the entries at once
+            WriteTypeRecords(Block::Bytes.data(), static_cast<uint32>(Block::Bytes.size()), Block::Ids.data(), Block::Offsets.data(), Block::Records.data(), static_cast<uint32>(Block::Ids.size()));
+            return true;
+        }
+
+        // Some of the referenced types are already written, so write each member that is missing and then this type
+        const bool are_members_written = [this]<typename... MemberTypes>(FxTypeList<MemberTypes...>) {
+            return (WriteTypeForTypeId<MemberTypes>() && ...);
+        }(typename FxTypeRecordTraits<BaseT>::Members{ });
+
+        if (!are_members_written) {
+            return false;
+        }
+
+        constexpr uint16 type_id = FxSerializeUtil::GetTypeId<BaseT>();
+        constexpr uint32 record_offset = 0;
+        const uint8* record = TypeRecord<BaseT>.data();
+
+        WriteTypeRecords(record, static_cast<uint32>(TypeRecord<BaseT>.size()), &type_id, &record_offset, &record, 1);
+
+        return true;
+    }
+
+    /**
+     * Returns the type for `id`, or nullptr if the type is not in the section. The returned pointer
+     * is valid until the next type is written or the section is reset.
+     */
+    const FxSerializedType* FindType(uint16 id);
+
+    /** Returns the type of member `member_index` of `type`, or nullptr if the member's type is not in the section. */
+    const FxSerializedType* GetMemberType(const FxSerializedType& type, uint32 member_index) const
+    {
+        const uint32 type_index = mMemberTypeIndices[type.MembersStart + member_index];
+
+        if (type_index == TypeNotFound) {
+            return nullptr;
         }
 
-        (WriteTypeForTypeId<std::remove_reference_t<decltype(args)>>(writer), ...);
+        return &mTypes[type_index];
+    }
+
+    /** Rewinds the section and forgets all written types, keeping the allocated buffer */
+    void Reset()
+    {
+        FxSerializerBaseSection::Reset();
+        ClearRegisteredTypes();
+    }
+
+    /** Takes ownership of the written buffer and forgets all written types, so the next message writes its own types */
+    FxSerializerBuffer Release()
+    {
+        ClearRegisteredTypes();
+        return FxSerializerBaseSection::Release();
+    }
+
+    /** Replaces the section's buffer with a type section that was written elsewhere, and indexes the types in it */
+    void Adopt(FxSerializerBuffer&& buffer)
+    {
+        const uint32 length = buffer.Size;
+
+        FxSerializerBaseSection::Adopt(std::move(buffer));
+
+        ClearRegisteredTypes();
+        IndexTypes(length);
+    }
+
+    /**
+     * Points the section at memory owned by the caller and forgets all written types, so the next message
+     * written into the buffer includes its own types. Call IndexTypes if the buffer already holds types.
+     */
+    void SetExternalBuffer(std::span<uint8> buffer)
+    {
+        FxSerializerBaseSection::SetExternalBuffer(buffer);
+        ClearRegisteredTypes();
+    }
 
-        WriteTypeWithoutChecks(type_id, type_size, std::forward<Types>(args)...);
+    /** Points the section at read only memory owned by the caller and forgets all written types, see SetExternalBuffer */
+    void SetReadOnlyBuffer(std::span<const uint8> buffer)
+    {
+        FxSerializerBaseSection::SetReadOnlyBuffer(buffer);
+        ClearRegisteredTypes();
     }
 
-    FxSerializedType ReadType(uint32 index);
+    /**
+     * Parses the first `length` bytes of the section into the type table that FindType uses. This is called
+     * by ReadFromFile and Adopt, and should be called after placing type data into the section by any other
+     * means, such as SetExternalBuffer.
+     */
+    void IndexTypes(uint32 length);
 
     void PrintAllTypes()
     {
@@ -407,13 +1227,133 @@ public:
         puts("");
     }
 
+    /** Returns the offset of the type entry for `id`, or TypeNotFound if the type is not in the section. */
     uint32 FindIndexFromTypeId(uint16 id);
 
+    static constexpr uint32 TypeNotFound = UINT32_MAX;
+
 private:
-    bool IsTypePreviouslyWritten(uint16 type_id);
+    /** Copies prebuilt type entries into the section and registers each type in them */
+    void WriteTypeRecords(const uint8* records, uint32 size, const uint16* type_ids, const uint32* offsets, const uint8* const* type_records, uint32 count)
+    {
+        const uint32 start_offset = Index;
+
+        WriteBuffer(size, records);
+
+        for (uint32 i = 0; i < count; i++) {
+            AddRegisteredType(type_ids[i], start_offset + offsets[i], type_records[i]);
+        }
+
+        mIsTypeIndexStale = true;
+    }
+
+    /** Builds the type and member tables from the registered type entries */
+    void BuildTypeTable();
+
+    /** Returns true if the entry at `offset` in the section matches the compile time entry `record` */
+    bool IsTypeRecordAt(uint32 offset, const uint8* record, uint32 size) const;
+
+    /**
+     * Compares a registered type against the entry being written for `type_name`. Two different types with
+     * the same id would make the section unreadable, so a mismatch is reported and returns false.
+     */
+    bool CheckRegisteredType(TypeEntry& entry, const uint8* record, uint32 size, std::string_view type_name);
+
+    /** Returns the registered entry for `type_id`, or nullptr if the type has not been written to the section */
+    inline TypeEntry* FindRegisteredType(uint16 type_id)
+    {
+        if (mRegisteredTypeSlots.empty()) {
+            return nullptr;
+        }
+
+        const uint32 mask = static_cast<uint32>(mRegisteredTypeSlots.size()) - 1;
+
+        for (uint32 slot = GetTypeSlot(type_id, mask); mRegisteredTypeSlots[slot] != 0; slot = (slot + 1) & mask) {
+            TypeEntry& entry = mRegisteredTypeIds[mRegisteredTypeSlots[slot] - 1];
+
+            if (entry.Id == type_id) {
+                return &entry;
+            }
+        }
+
+        return nullptr;
+    }
+
+    inline bool IsTypePreviouslyWritten(uint16 type_id)
+    {
+        return FindRegisteredType(type_id) != nullptr;
+    }
+
+    /** Adds a type entry at `offset` to the registered types. If the id is already registered, the first entry is kept. */
+    void AddRegisteredType(uint16 type_id, uint32 offset, const uint8* record = nullptr)
+    {
+        if (IsTypePreviouslyWritten(type_id)) {
+            return;
+        }
+
+        mRegisteredTypeIds.emplace_back(TypeEntry{ type_id, offset, record });
+
+        // Keep the table at most half full so that probes stay short
+        if (mRegisteredTypeIds.size() * 2 > mRegisteredTypeSlots.size()) {
+            RebuildTypeSlots(mRegisteredTypeSlots.empty() ? MinTypeSlotCount : static_cast<uint32>(mRegisteredTypeSlots.size()) * 2);
+        }
+        else {
+            InsertTypeSlot(static_cast<uint32>(mRegisteredTypeIds.size()) - 1);
+        }
+    }
+
+    static inline uint32 GetTypeSlot(uint16 type_id, uint32 mask)
+    {
+        // Declared ids are often sequential, so spread them out before masking
+        return (static_cast<uint32>(type_id) * 0x9E3779B1u >> 16) & mask;
+    }
+
+    void InsertTypeSlot(uint32 entry_index)
+    {
+        const uint32 mask = static_cast<uint32>(mRegisteredTypeSlots.size()) - 1;
+
+        uint32 slot = GetTypeSlot(mRegisteredTypeIds[entry_index].Id, mask);
+        while (mRegisteredTypeSlots[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+
+        mRegisteredTypeSlots[slot] = entry_index + 1;
+    }
+
+    void RebuildTypeSlots(uint32 slot_count)
+    {
+        mRegisteredTypeSlots.assign(slot_count, 0);
+
+        for (uint32 i = 0; i < mRegisteredTypeIds.size(); i++) {
+            InsertTypeSlot(i);
+        }
+    }
+
+    void ClearRegisteredTypes()
+    {
+        mRegisteredTypeIds.clear();
+
+        // The table only grows with the number of types written, so clearing it is cheap
+        std::fill(mRegisteredTypeSlots.begin(), mRegisteredTypeSlots.end(), 0);
+
+        mTypes.clear();
+        mMemberTypeIndices.clear();
+        mIsTypeIndexStale = true;
+    }
 
 private:
     std::vector<TypeEntry> mRegisteredTypeIds;
+
+    /// Open addressed table of registered types. Each slot holds an index into mRegisteredTypeIds plus one, or zero if empty.
+    static constexpr uint32 MinTypeSlotCount = 32;
+    std::vector<uint32> mRegisteredTypeSlots;
+
+    /// Registered types sorted by id, rebuilt on the next lookup after a type is written
+    std::vector<FxSerializedType> mTypes;
+
+    /// Index into mTypes for the members of every type, in order
+    std::vector<uint32> mMemberTypeIndices;
+    bool mIsTypeIndexStale = true;
 };
 
 ///////////////////////////////
@@ -423,24 +1363,197 @@ private:
 // Multichars, easy to compare as we just need to compare the signatures as uint32s.
 #define FX_SERIALIZER_IO_FILE_SIGNATURE 'DSXF' // FXSD
 #define FX_SERIALIZER_IO_SECTION_DATA_SIGNATURE 'TAD.' // .DAT
+#define FX_SERIALIZER_IO_SECTION_DIRECTORY_SIGNATURE 'RID.' // .DIR
+
+/// File header flag that is set when the sections are stored in little-endian byte order
+#define FX_SERIALIZER_IO_FLAG_LITTLE_ENDIAN 0x01
+
+/// File header flag that is set when integers are stored as variable length values
+#define FX_SERIALIZER_IO_FLAG_VARINT 0x02
+
+/// File header flag that is set when nested structs are stored without entry headers and footers
+#define FX_SERIALIZER_IO_FLAG_COMPACT_STRUCTS 0x04
+
+/// File header flag that is set when the file ends with a directory of its top level entries
+#define FX_SERIALIZER_IO_FLAG_DIRECTORY 0x08
+
+/**
+ * A file mapped into memory as read only pages. The file is unmapped when this is destroyed.
+ */
+class FxSerializerMappedFile
+{
+public:
+    FxSerializerMappedFile() = default;
+
+    FxSerializerMappedFile(const FxSerializerMappedFile& other) = delete;
+    FxSerializerMappedFile& operator = (const FxSerializerMappedFile& other) = delete;
+
+    FxSerializerMappedFile(FxSerializerMappedFile&& other) noexcept
+        : mData(std::exchange(other.mData, nullptr)), mSize(std::exchange(other.mSize, 0))
+    {
+    }
+
+    FxSerializerMappedFile& operator = (FxSerializerMappedFile&& other) noexcept
+    {
+        if (this != &other) {
+            Unmap();
+
+            mData = std::exchange(other.mData, nullptr);
+            mSize = std::exchange(other.mSize, 0);
+        }
+        return *this;
+    }
+
+    ~FxSerializerMappedFile()
+    {
+        Unmap();
+    }
+
+    /** Maps the entire file into memory, unmapping any previous file. Returns false if the file could not be mapped. */
+    bool Map(const char* filename);
+
+    void Unmap();
+
+    std::span<const uint8> GetData() const
+    {
+        return std::span<const uint8>(mData, mSize);
+    }
+
+    bool IsMapped() const
+    {
+        return mData != nullptr;
+    }
+
+private:
+    uint8* mData = nullptr;
+    size_t mSize = 0;
+};
+
+/** Location of a top level entry in the data section, see FxSerializerIO::EnableDirectory */
+struct FxSerializerDirectoryEntry
+{
+    FxHash NameHash;
+    uint32 Offset;
+};
 
 class FxSerializerIO
 {
 public:
-    FxSerializerIO(uint32 buffer_size=10'000)
+    /**
+     * Creates an IO with empty sections. Nothing is allocated until a section is first written to, at which
+     * point it is allocated with `buffer_size` bytes and grows on demand from there.
+     */
+    FxSerializerIO(uint32 buffer_size=FxSerializerBaseSection::MinimumCapacity)
     {
-        TypeSection.Create(buffer_size);
-        DataSection.Create(buffer_size);
+        TypeSection.InitialCapacity = buffer_size;
+        DataSection.InitialCapacity = buffer_size;
     }
 
     void PrintReadableEntry(uint32 start_index);
 
+    /**
+     * Clears all written types and data so that the IO can be reused, keeping the capacity
+     * of both sections. The varint, compact struct and directory settings are kept.
+     */
+    void Reset()
+    {
+        TypeSection.Reset();
+        DataSection.Reset();
+        mDirectory.clear();
+    }
+
     /** Writes all sections of the serialized data to a file */
     void WriteToFile(const char* filename);
 
     /** Reads serialized data from a file into memory */
     void ReadFromFile(const char* filename);
 
+    /**
+     * Memory maps a file and points the sections directly at the mapped data, so nothing is read up front
+     * and pages are loaded from disk as they are used. The mapping is kept until the IO is destroyed or
+     * another file is read. Returns false if the file could not be mapped or is not valid.
+     */
+    bool MapFromFile(const char* filename);
+
+    /**
+     * Points the sections at a serialized file that is already in memory, without copying it. Each section
+     * length is checked against the size of `file`. The memory must stay valid while the IO reads from it.
+     * It is never written to: values from a foreign byte order are swapped as they are read, and writing
+     * to the IO copies a section into its own buffer first. Returns false if the file is not valid.
+     */
+    bool ReadFromMemory(std::span<const uint8> file);
+
+    /**
+     * Enables variable length integers for all values written to this IO. Signed values are zigzag
+     * encoded, and integer arrays are written in the Stream VByte format. This is recorded in the
+     * file header, so it should be set before anything is written.
+     */
+    void EnableVarInts(bool enabled=true)
+    {
+        DataSection.UseVarInts = enabled;
+    }
+
+    /**
+     * Writes nested structs as their members only, without the entry header, type id, name hash and
+     * footer. The layout of each struct is fixed by the type section, so top level entries still have
+     * their framing, but nested structs can no longer be inspected on their own. This is recorded in
+     * the file header, so it should be set before anything is written.
+     */
+    void EnableCompactStructs(bool enabled=true)
+    {
+        DataSection.UseCompactStructs = enabled;
+    }
+
+    /**
+     * Records the data offset of each named top level entry, and writes them to a directory section at
+     * the end of the file. Readers can then use SeekToEntry to read entries in any order, rather than
+     * in the order they were written.
+     */
+    void EnableDirectory(bool enabled=true)
+    {
+        mUseDirectory = enabled;
+    }
+
+    /** Adds a top level entry to the directory. This is called by WriteTo before the entry is written. */
+    inline void AddDirectoryEntry(FxHash name_hash, uint32 offset)
+    {
+        // Entries without a name cannot be looked up
+        if (mUseDirectory && name_hash != 0) {
+            mDirectory.emplace_back(FxSerializerDirectoryEntry{ name_hash, offset });
+            mIsDirectorySorted = false;
+        }
+    }
+
+    /** Returns the offset in the data section of the entry named `name_hash`, or UINT32_MAX if it is not in the directory */
+    uint32 FindEntry(FxHash name_hash);
+
+    /**
+     * Moves the data section to the entry named `name_hash` so that it can be read with ReadFrom.
+     * Returns false if the file has no directory, the entry is not in it, or its offset is outside of the data section.
+     */
+    bool SeekToEntry(FxHash name_hash)
+    {
+        const uint32 offset = FindEntry(name_hash);
+
+        if (offset == UINT32_MAX) {
+            return false;
+        }
+
+        if (static_cast<uint64>(offset) + FxSerializerDataSection::EntryHeaderSize > DataSection.Size) {
+            printf("Directory offset %u is outside of the data section!\n", offset);
+            return false;
+        }
+
+        DataSection.Index = offset;
+        return true;
+    }
+
+    /** Returns the header flags that describe data written on this machine */
+    static constexpr uint8 GetNativeFlags()
+    {
+        return (std::endian::native == std::endian::little) ? FX_SERIALIZER_IO_FLAG_LITTLE_ENDIAN : 0;
+    }
+
 private:
     void PrintBinaryValue(uint8 value)
     {
@@ -460,25 +1573,288 @@ private:
 public:
     FxSerializerTypeSection TypeSection;
     FxSerializerDataSection DataSection;
-};
 
-/////////////////////////////////
-// Serializer Functions
-/////////////////////////////////
+    /** Points the sections back at their own buffers and unmaps the file loaded by MapFromFile, if any */
+    void ReleaseMappedFile();
 
-// Base FxSerializeValue and FxDeserializeValue implementations, specializations are located in .cpp file
-template <typename T>
-void FxSerializeValue(FxSerializerIO& writer, const T& value)
-{
-    std::cout << "Type " << typeid(T).name() << " is not serializable!\n";
-}
+private:
+    /** Sorts the directory by name hash, keeping entries with the same name in the order they were written */
+    void SortDirectory();
 
-template <typename T>
-void FxDeserializeValue(FxSerializerIO& writer, T dest)
-{
-    std::cout << "Type " << typeid(T).name() << " is not deserializable!\n";
-}
+private:
+    /// File that the sections point into after MapFromFile
+    FxSerializerMappedFile mMappedFile;
+
+    /// Top level entries, sorted by name hash when mIsDirectorySorted is set
+    std::vector<FxSerializerDirectoryEntry> mDirectory;
+    bool mIsDirectorySorted = false;
+
+    bool mUseDirectory = false;
+};
+
+/**
+ * Hands out reusable FxSerializerIO objects so that their buffers are only allocated once. IO objects
+ * are owned by the pool and are reset when they are released back to it, so they must not be used after
+ * the pool is destroyed. This is not thread safe, use a pool per thread.
+ */
+class FxSerializerIOPool
+{
+public:
+    FxSerializerIOPool() = default;
+
+    FxSerializerIOPool(const FxSerializerIOPool& other) = delete;
+    FxSerializerIOPool& operator = (const FxSerializerIOPool& other) = delete;
+
+    /**
+     * Creates `count` IO objects up front with both sections allocated to `buffer_size` bytes. The
+     * buffers are touched so that their pages are faulted in before the first use.
+     */
+    void Create(uint32 count, uint32 buffer_size);
+
+    /** Returns an empty IO, creating a new one if the pool is empty */
+    FxSerializerIO* Acquire();
+
+    /**
+     * Resets `io`, including its varint, compact struct and directory settings, and returns it to the pool.
+     * Any file mapped with MapFromFile is unmapped. `io` must have been acquired from this pool.
+     */
+    void Release(FxSerializerIO* io);
+
+    uint32 GetFreeCount() const
+    {
+        return static_cast<uint32>(mFreeIOs.size());
+    }
+
+private:
+    /// Every IO created by the pool, whether it is free or in use
+    std::vector<std::unique_ptr<FxSerializerIO>> mIOs;
+
+    /// IOs that are ready to be acquired
+    std::vector<FxSerializerIO*> mFreeIOs;
+
+    uint32 mBufferSize = FxSerializerBaseSection::MinimumCapacity;
+};
+
+/////////////////////////////////
+// Serializer Functions
+/////////////////////////////////
+
+// Base FxSerializeValue and FxDeserializeValue implementations, specializations are located in .cpp file
+template <typename T>
+void FxSerializeValue(FxSerializerIO& writer, const T& value)
+{
+    std::cout << "Type " << typeid(T).name() << " is not serializable!\n";
+}
+
+template <typename T>
+void FxDeserializeValue(FxSerializerIO& writer, T dest)
+{
+    std::cout << "Type " << typeid(T).name() << " is not deserializable!\n";
+}
+
+template <> void FxSerializeValue(FxSerializerIO& writer, const std::string& value);
+template <> void FxSerializeValue(FxSerializerIO& writer, const std::string_view& value);
+template <> void FxSerializeValue(FxSerializerIO& writer, const std::span<const uint8>& value);
+
+template <> void FxDeserializeValue(FxSerializerIO& reader, std::string* value);
+
+// Views are read without copying and point into the reader's data section, see FxSerializerDataSection::ReadStringView
+template <> void FxDeserializeValue(FxSerializerIO& reader, std::string_view* value);
+template <> void FxDeserializeValue(FxSerializerIO& reader, std::span<const uint8>* value);
+
+
+/**
+ * Reads and writes a primitive value in the data section. Each value is stored as an unsigned word
+ * of the same size, with floating point values bit cast so that they round trip exactly. Enums are
+ * written as their underlying type, and integers are written as LEB128 when varints are enabled.
+ */
+template <typename T> requires C_IsPrimitive<T>
+struct FxPrimitiveCodec
+{
+    using WordType = FxUintOfSize<sizeof(T)>;
+
+    static inline void Write(FxSerializerDataSection& data, T value)
+    {
+        if constexpr (std::is_enum_v<T>) {
+            FxPrimitiveCodec<std::underlying_type_t<T>>::Write(data, static_cast<std::underlying_type_t<T>>(value));
+        }
+        else {
+            if constexpr (C_IsVarIntType<T>) {
+                if (data.UseVarInts) {
+                    data.WriteVarInt(value);
+                    return;
+                }
+            }
+
+            const WordType word = std::bit_cast<WordType>(value);
+
+            if constexpr (sizeof(T) == 1) {
+                data.Write8(word);
+            }
+            else if constexpr (sizeof(T) == 2) {
+                data.Write16(word);
+            }
+            else if constexpr (sizeof(T) == 4) {
+                data.Write32(word);
+            }
+            else {
+                data.Write64(word);
+            }
+        }
+    }
+
+    static inline T Read(FxSerializerDataSection& data)
+    {
+        if constexpr (std::is_enum_v<T>) {
+            return static_cast<T>(FxPrimitiveCodec<std::underlying_type_t<T>>::Read(data));
+        }
+        else {
+            if constexpr (C_IsVarIntType<T>) {
+                if (data.UseVarInts) {
+                    return data.ReadVarInt<T>();
+                }
+            }
+
+            WordType word;
+
+            if constexpr (sizeof(T) == 1) {
+                word = data.Read8();
+            }
+            else if constexpr (sizeof(T) == 2) {
+                word = data.Read16();
+            }
+            else if constexpr (sizeof(T) == 4) {
+                word = data.Read32();
+            }
+            else {
+                word = data.Read64();
+            }
+
+            // Any byte other than zero could be an invalid bool, so compare rather than cast
+            if constexpr (std::is_same_v<T, bool>) {
+                return word != 0;
+            }
+            else {
+                return std::bit_cast<T>(word);
+            }
+        }
+    }
+};
+
+
+template <typename MemberPtrsTuple>
+struct FxSerializerMemberInfo;
+
+/**
+ * Returns true if a value of type `T` can be serialized by copying its bytes directly. This is
+ * true for primitives other than bool, and for serializable structs where every member is trivially
+ * serializable and there is no padding or unlisted data inside of the struct.
+ */
+template <typename T>
+constexpr bool FxIsTriviallySerializable()
+{
+    if constexpr (std::is_same_v<T, bool>) {
+        // Any byte other than 0 or 1 is an invalid bool, so these are read through the codec which normalizes them
+        return false;
+    }
+    else if constexpr (C_IsPrimitive<T>) {
+        return true;
+    }
+    else if constexpr (C_IsSerializable<T>) {
+        using MemberInfo = FxSerializerMemberInfo<typename T::SerializerMembers_>;
+
+        return std::is_trivially_copyable_v<T> && MemberInfo::IsTrivial && MemberInfo::TotalSize == sizeof(T);
+    }
+    else {
+        return false;
+    }
+}
+
+/**
+ * Returns true if `T` is a serializable struct with a struct member. Member structs have their own entry header
+ * unless compact structs are enabled, so these cannot be copied as one block in the default mode.
+ */
+template <typename T>
+constexpr bool FxHasNestedStructs()
+{
+    if constexpr (C_IsSerializable<T>) {
+        return FxSerializerMemberInfo<typename T::SerializerMembers_>::HasStructs;
+    }
+    else {
+        return false;
+    }
+}
+
+/** Returns true if `T` is, or contains members, that are written differently when variable length integers are enabled */
+template <typename T>
+constexpr bool FxHasVarInts()
+{
+    if constexpr (C_IsVarIntType<T>) {
+        return true;
+    }
+    else if constexpr (std::is_enum_v<T>) {
+        return C_IsVarIntType<std::underlying_type_t<T>>;
+    }
+    else if constexpr (C_IsSerializable<T>) {
+        return FxSerializerMemberInfo<typename T::SerializerMembers_>::HasVarInts;
+    }
+    else {
+        return false;
+    }
+}
+
+/** Compile time information about the members passed to FX_SERIALIZABLE_MEMBERS */
+template <typename... Types>
+struct FxSerializerMemberInfo<std::tuple<Types*...>>
+{
+    /// Size of all members combined, excluding any padding
+    static constexpr size_t TotalSize = (sizeof(Types) + ... + 0);
+
+    /// All members can be copied as raw bytes
+    static constexpr bool IsTrivial = (FxIsTriviallySerializable<std::remove_const_t<Types>>() && ...);
 
+    /// Any member is written as a variable length integer when they are enabled
+    static constexpr bool HasVarInts = (FxHasVarInts<std::remove_const_t<Types>>() || ...);
+
+    /// Any member is a serializable struct, which is written with its own entry header outside of compact mode
+    static constexpr bool HasStructs = (C_IsSerializable<std::remove_const_t<Types>> || ...);
+};
+
+template <typename T>
+inline bool FxIsMemberContiguous(const T& value)
+{
+    if constexpr (C_IsSerializable<T>) {
+        return value.SerializerIsContiguous_();
+    }
+    else {
+        return true;
+    }
+}
+
+/**
+ * Returns true if all members are laid out back to back in memory in the order that they are
+ * passed in, meaning that they can be copied as one block. The addresses are relative to the
+ * same object, so this is folded to a constant by the compiler.
+ */
+template <typename First, typename... Rest>
+inline bool FxMembersAreContiguous(const First& first, const Rest&... rest)
+{
+    bool is_contiguous = FxIsMemberContiguous(first);
+
+    // Single member structs have nothing to compare against
+    if constexpr (sizeof...(Rest) > 0) {
+        const uint8* next_address = reinterpret_cast<const uint8*>(&first) + sizeof(First);
+
+        auto check_member = [&](const auto& member) {
+            is_contiguous = is_contiguous && reinterpret_cast<const uint8*>(&member) == next_address && FxIsMemberContiguous(member);
+            next_address += sizeof(member);
+        };
+
+        (check_member(rest), ...);
+    }
+
+    return is_contiguous;
+}
 
 /**
  * Serializes a structure and writes to the SerializerIO `writer`.
@@ -486,53 +1862,408 @@ void FxDeserializeValue(FxSerializerIO& writer, T dest)
 template <typename T> requires C_IsSerializable<T>
 void FxSerializeValue(FxSerializerIO& writer, const T& value)
 {
-    value.WriteTo(0, writer);
+    if (writer.DataSection.UseCompactStructs) {
+        value.WriteDataTo(writer);
+    }
+    else {
+        // The outer struct registered every type it references, so only the entry is written here
+        value.WriteEntryTo(0, writer);
+    }
 }
 
 /** Deserializes a structure */
 template <typename T> requires C_IsSerializable<T>
 void FxDeserializeValue(FxSerializerIO& reader, T* value)
 {
-    value->ReadFrom(0, reader);
+    if (reader.DataSection.UseCompactStructs) {
+        value->ReadDataFrom(reader);
+    }
+    else {
+        value->ReadFrom(0, reader);
+    }
 }
 
 /**
- * Serializes a byte-sized value
+ * Serializes a primitive value
  */
-template <typename T> requires C_IsByteType<T>
+template <typename T> requires C_IsPrimitive<T>
 void FxSerializeValue(FxSerializerIO& writer, const T& value)
 {
-    writer.DataSection.Write8(value);
+    FxPrimitiveCodec<T>::Write(writer.DataSection, value);
 }
 
 /**
- * Deserializes a byte-sized value
+ * Deserializes a primitive value
  */
-template <typename T> requires C_IsByteType<T>
+template <typename T> requires C_IsPrimitive<T>
 void FxDeserializeValue(FxSerializerIO& reader, T* value)
 {
-    (*value) = reader.DataSection.Read8();
+    (*value) = FxPrimitiveCodec<T>::Read(reader.DataSection);
+}
+
+
+/**
+ * Reverses the byte order of `count` 16, 32, or 64 bit words in place. These use SSSE3 or AVX2
+ * when the CPU supports it, and fall back to a scalar loop otherwise.
+ */
+void FxSwapArrayBytes16(uint8* data, uint32 count);
+void FxSwapArrayBytes32(uint8* data, uint32 count);
+void FxSwapArrayBytes64(uint8* data, uint32 count);
+
+/**
+ * Reverses the byte order of each value in an array of primitives, used when reading
+ * values written on a machine with a different byte order.
+ */
+template <typename T>
+inline void FxSwapArrayBytes(T* values, uint32 count)
+{
+    uint8* data = reinterpret_cast<uint8*>(values);
+
+    if constexpr (sizeof(T) == 2) {
+        FxSwapArrayBytes16(data, count);
+    }
+    else if constexpr (sizeof(T) == 4) {
+        FxSwapArrayBytes32(data, count);
+    }
+    else if constexpr (sizeof(T) == 8) {
+        FxSwapArrayBytes64(data, count);
+    }
 }
 
+/// Number of values that are encoded at a time when converting integer arrays to Stream VByte
+static constexpr uint32 FxStreamVByteChunkSize = 256;
+
+/**
+ * Encodes 32 bit values in the Stream VByte format. Each value takes 1-4 bytes, and the lengths
+ * are stored two bits per value in `control`. Returns the end of the written data.
+ */
+uint8* FxStreamVByteEncode(const uint32* values, uint32 count, uint8* control, uint8* data);
+
+/**
+ * Decodes `count` values encoded with FxStreamVByteEncode. This uses SSSE3 when available.
+ * Returns the end of the consumed data, or nullptr if the data would be read past `data_end`.
+ */
+const uint8* FxStreamVByteDecode(const uint8* control, const uint8* data, const uint8* data_end, uint32 count, uint32* values);
+
+/**
+ * Writes an integer array as variable length values. 64 bit values are written as LEB128, and
+ * smaller values are written in the Stream VByte format.
+ */
+template <typename T> requires C_IsVarIntType<T>
+void FxWriteVarIntArray(FxSerializerDataSection& data, const T* values, uint32 count)
+{
+    if constexpr (sizeof(T) == 8) {
+        for (uint32 i = 0; i < count; i++) {
+            data.WriteVarInt(values[i]);
+        }
+    }
+    else {
+        const uint32 control_size = (count + 3) / 4;
+
+        data.Reserve(static_cast<uint64>(control_size) + static_cast<uint64>(count) * sizeof(uint32));
+
+        uint8* control = data.Data + data.Index;
+        uint8* output = control + control_size;
+
+        uint32 chunk[FxStreamVByteChunkSize];
+
+        for (uint32 start = 0; start < count; start += FxStreamVByteChunkSize) {
+            const uint32 chunk_count = std::min(FxStreamVByteChunkSize, count - start);
+
+            for (uint32 i = 0; i < chunk_count; i++) {
+                if constexpr (std::is_signed_v<T>) {
+                    chunk[i] = FxZigZagEncode(values[start + i]);
+                }
+                else {
+                    chunk[i] = values[start + i];
+                }
+            }
+
+            output = FxStreamVByteEncode(chunk, chunk_count, control + start / 4, output);
+        }
+
+        data.Index = static_cast<uint32>(output - data.Data);
+    }
+}
+
+/** Reads an integer array written with FxWriteVarIntArray */
+template <typename T> requires C_IsVarIntType<T>
+void FxReadVarIntArray(FxSerializerDataSection& data, T* values, uint32 count)
+{
+    if constexpr (sizeof(T) == 8) {
+        for (uint32 i = 0; i < count; i++) {
+            values[i] = data.ReadVarInt<T>();
+        }
+    }
+    else {
+        const uint32 control_size = (count + 3) / 4;
+
+        if (control_size > data.Size - data.Index) {
+            printf("Varint array control bytes are larger than the remaining data!\n");
+            return;
+        }
+
+        const uint8* control = data.Data + data.Index;
+        const uint8* input = control + control_size;
+        const uint8* input_end = data.Data + data.Size;
+
+        uint32 chunk[FxStreamVByteChunkSize];
+
+        for (uint32 start = 0; start < count && input != nullptr; start += FxStreamVByteChunkSize) {
+            const uint32 chunk_count = std::min(FxStreamVByteChunkSize, count - start);
+
+            // Unsigned 32 bit values are decoded directly into the destination
+            if constexpr (std::is_same_v<T, uint32>) {
+                input = FxStreamVByteDecode(control + start / 4, input, input_end, chunk_count, values + start);
+                continue;
+            }
+
+            input = FxStreamVByteDecode(control + start / 4, input, input_end, chunk_count, chunk);
+
+            for (uint32 i = 0; i < chunk_count; i++) {
+                using UnsignedType = std::make_unsigned_t<T>;
+
+                if constexpr (std::is_signed_v<T>) {
+                    values[start + i] = FxZigZagDecode(static_cast<UnsignedType>(chunk[i]));
+                }
+                else {
+                    values[start + i] = static_cast<T>(chunk[i]);
+                }
+            }
+        }
+
+        if (input == nullptr) {
+            printf("Varint array is larger than the remaining data!\n");
+            return;
+        }
+
+        data.Index = static_cast<uint32>(input - data.Data);
+    }
+}
+
+/**
+ * Serializes a single container element. Structs are written without an entry header as the
+ * element type is already known from the container.
+ */
+template <typename T>
+inline void FxSerializeElement(FxSerializerIO& writer, const T& value)
+{
+    if constexpr (C_IsSerializable<T>) {
+        value.WriteDataTo(writer);
+    }
+    else {
+        FxSerializeValue<T>(writer, value);
+    }
+}
+
+template <typename T>
+inline void FxDeserializeElement(FxSerializerIO& reader, T* value)
+{
+    if constexpr (C_IsSerializable<T>) {
+        value->ReadDataFrom(reader);
+    }
+    else {
+        FxDeserializeValue(reader, value);
+    }
+}
+
+/**
+ * Serializes a contiguous container (std::vector, std::array, or a C array) as the number of elements
+ * followed by each element. Arrays of trivially serializable values are written with a single copy.
+ */
+template <typename T> requires C_IsContainer<T>
+void FxSerializeValue(FxSerializerIO& writer, const T& value)
+{
+    using ElementType = typename FxContainerTraits<T>::ElementType;
+
+    FxSerializerDataSection& data = writer.DataSection;
+
+    const uint32 count = static_cast<uint32>(std::size(value));
+    const ElementType* elements = std::data(value);
+
+    data.Write32(count);
+
+    if (count == 0) {
+        return;
+    }
+
+    if constexpr (C_IsVarIntType<ElementType>) {
+        if (data.UseVarInts) {
+            FxWriteVarIntArray(data, elements, count);
+            return;
+        }
+    }
+
+    if constexpr (FxIsTriviallySerializable<ElementType>()) {
+        const bool is_flat = !FxHasNestedStructs<ElementType>() || data.UseCompactStructs;
+
+        if (is_flat && FxIsMemberContiguous(elements[0]) && !(FxHasVarInts<ElementType>() && data.UseVarInts)) {
+            const uint64 buffer_size = static_cast<uint64>(count) * sizeof(ElementType);
+
+            data.Reserve(buffer_size);
+            data.WriteBuffer(static_cast<uint32>(buffer_size), reinterpret_cast<const uint8*>(elements));
+
+            return;
+        }
+    }
+
+    for (uint32 i = 0; i < count; i++) {
+        FxSerializeElement(writer, elements[i]);
+    }
+}
+
+/**
+ * Deserializes a container written by FxSerializeValue. Fixed size arrays must have the same number
+ * of elements that were written.
+ */
+template <typename T> requires C_IsContainer<T>
+void FxDeserializeValue(FxSerializerIO& reader, T* value)
+{
+    using Traits = FxContainerTraits<T>;
+    using ElementType = typename Traits::ElementType;
+
+    FxSerializerDataSection& data = reader.DataSection;
+
+    const uint32 count = data.Read32();
+
+    // Each element takes at least one byte, so a count larger than the remaining data is invalid.
+    if (count > data.Size - data.Index) {
+        printf("Container size of %u elements is larger than the remaining data!\n", count);
+        return;
+    }
+
+    if constexpr (Traits::IsResizable) {
+        value->resize(count);
+    }
+    else if (count != std::size(*value)) {
+        printf("Array size mismatch! %u != %zu\n", count, std::size(*value));
+        return;
+    }
+
+    if (count == 0) {
+        return;
+    }
+
+    ElementType* elements = std::data(*value);
+
+    if constexpr (C_IsVarIntType<ElementType>) {
+        if (data.UseVarInts) {
+            FxReadVarIntArray(data, elements, count);
+            return;
+        }
+    }
+
+    if constexpr (FxIsTriviallySerializable<ElementType>()) {
+        const uint64 buffer_size = static_cast<uint64>(count) * sizeof(ElementType);
+
+        if (buffer_size > data.Size - data.Index) {
+            printf("Container data is larger than the remaining data!\n");
+            return;
+        }
+
+        const bool is_flat = !FxHasNestedStructs<ElementType>() || data.UseCompactStructs;
+
+        if (is_flat && FxIsMemberContiguous(elements[0]) && !(FxHasVarInts<ElementType>() && data.UseVarInts)) {
+            if (!data.SwapBytes) {
+                data.ReadBuffer(static_cast<uint32>(buffer_size), reinterpret_cast<uint8*>(elements));
+                return;
+            }
+
+            if constexpr (C_IsPrimitive<ElementType>) {
+                data.ReadBuffer(static_cast<uint32>(buffer_size), reinterpret_cast<uint8*>(elements));
+                FxSwapArrayBytes(elements, count);
+                return;
+            }
+        }
+    }
+
+    for (uint32 i = 0; i < count; i++) {
+        FxDeserializeElement(reader, &elements[i]);
+    }
+}
+
+
+/**
+ * Serializes each member of a struct without an entry header. If all members are trivially
+ * serializable and contiguous in memory, they are written with a single copy. Member structs
+ * are only copied this way in compact mode, as they otherwise keep their entry header.
+ */
+template <typename... Types>
+inline void FxSerializeMembers(FxSerializerIO& writer, const Types&... members)
+{
+    using MemberInfo = FxSerializerMemberInfo<std::tuple<Types*...>>;
+
+    if constexpr (MemberInfo::IsTrivial) {
+        const bool has_varints = MemberInfo::HasVarInts && writer.DataSection.UseVarInts;
+        const bool is_flat = !MemberInfo::HasStructs || writer.DataSection.UseCompactStructs;
+
+        if (is_flat && !has_varints && FxMembersAreContiguous(members...)) {
+            const uint8* start = reinterpret_cast<const uint8*>(&std::get<0>(std::tie(members...)));
+            writer.DataSection.WriteBuffer(MemberInfo::TotalSize, start);
+            return;
+        }
+    }
+
+    (FxSerializeValue<Types>(writer, members), ...);
+}
 
 template <typename... Types>
-constexpr void FxSerializeStruct(FxSerializerIO& writer, uint16 type_id, FxHash name_hash, Types... members)
+constexpr void FxSerializeStruct(FxSerializerIO& writer, uint16 type_id, FxHash name_hash, const Types&... members)
 {
     FxSerializerDataSection& data = writer.DataSection;
-    data.WriteHeader(type_id, name_hash);
-    (FxSerializeValue<decltype(members)>(writer, members), ...);
-    data.WriteFooter();
+    const uint32 length_offset = data.WriteHeader(type_id, name_hash);
+    FxSerializeMembers(writer, members...);
+    data.WriteFooter(length_offset);
 }
 
 template <typename Type>
 // Note that std::remove_cvref_t won't work here, this order is important!
 using T_ExtractBarePtrType = std::remove_const_t<std::remove_pointer_t<std::remove_reference_t<Type>>>*;
 
+/**
+ * Deserializes each member of a struct that was written with FxSerializeMembers.
+ */
+template <typename... Types>
+inline void FxDeserializeMembers(FxSerializerIO& reader, std::tuple<Types...> members)
+{
+    using MemberInfo = FxSerializerMemberInfo<std::tuple<Types...>>;
+
+    FxSerializerDataSection& data = reader.DataSection;
+
+    // If the data was written on a machine with a different byte order, each member needs to be swapped.
+    if constexpr (MemberInfo::IsTrivial) {
+        const bool is_contiguous = std::apply([](auto*... v) { return FxMembersAreContiguous(*v...); }, members);
+        const bool has_varints = MemberInfo::HasVarInts && data.UseVarInts;
+        const bool is_flat = !MemberInfo::HasStructs || data.UseCompactStructs;
+
+        if (is_contiguous && is_flat && !has_varints && !data.SwapBytes) {
+            uint8* start = reinterpret_cast<uint8*>(const_cast<T_ExtractBarePtrType<decltype(std::get<0>(members))>>(std::get<0>(members)));
+            data.ReadBuffer(MemberInfo::TotalSize, start);
+            return;
+        }
+    }
+
+    std::apply(
+        [&reader](auto&&... v)
+        {
+            (FxDeserializeValue(reader, const_cast<T_ExtractBarePtrType<decltype(v)>>(v)), ...);
+        },
+        members
+    );
+}
+
 template <typename... Types>
 constexpr void FxDeserializeStruct(FxSerializerIO& writer, FxHash name_hash, std::tuple<Types...> members)
 {
     FxSerializerDataSection& data = writer.DataSection;
 
+    if (data.Index + FxSerializerDataSection::EntryHeaderSize > data.Size) {
+        printf("Entry header runs past the end of the section!\n");
+        return;
+    }
+
+    const uint32 start_index = data.Index;
+
     uint8 temp;
     temp = data.Read8();
     if (temp != FxSerializerDataSection::DataIdentHeader) {
@@ -540,22 +2271,37 @@ constexpr void FxDeserializeStruct(FxSerializerIO& writer, FxHash name_hash, std
         return;
     }
 
-    uint16 type_id = data.Read16();
+    data.Read16(); // type id
 
     uint32 struct_hash = data.Read32();
+
+    const uint32 length = data.Read32();
+
+    // The length comes from the file, so make sure the entry and its footer are inside the section before using it
+    if (static_cast<uint64>(data.Index) + length + sizeof(uint8) > data.Size) {
+        printf("Entry length %u runs past the end of the section!\n", length);
+        data.Index = start_index;
+        return;
+    }
+
+    const uint32 entry_end = data.Index + length;
+
     if (struct_hash && struct_hash != name_hash) {
         printf("Name hashes are not equal! %x != %x\n", struct_hash, name_hash);
+
+        // Skip past the entry so that the next one can be read
+        data.Index = entry_end + sizeof(uint8);
         return;
     }
 
-    //(FxDeserializeValue<decltype(members)>(writer, members), ...);
-    std::apply(
-        [&writer](auto&&... v)
-        {
-            (FxDeserializeValue(writer, const_cast<T_ExtractBarePtrType<decltype(v)>>(v)), ...);
-        },
-        members
-    );
+    FxDeserializeMembers(writer, members);
+
+    if (data.Index > entry_end) {
+        printf("Entry read past its length! (%u > %u)\n", data.Index, entry_end);
+    }
+
+    // Skip any data at the end of the entry that we do not know about, such as members added by a newer writer
+    data.Index = entry_end;
 
     temp = data.Read8();
     if (temp != FxSerializerDataSection::DataIdentFooter) {
@@ -577,18 +2323,45 @@ auto FxValuesToPtrsTuple(Types&... args)
     return std::tuple<Types*...>{ &args... };
 }
 
+// The type id is a property of the type (see FxSerializeUtil::GetTypeId), so nothing is stored in each instance.
+// WriteTo registers the type with the IO before writing the entry. Once the type has been written, registration is
+// a lookup in the type section's small hash table of written ids, and WriteEntryTo skips it entirely for callers
+// that know the type is already registered.
 #define FX_SERIALIZABLE_MEMBERS(...) \
-    const uint16 SerializerTypeId_ = FxSerializeUtil::GetTypeId<decltype(*this)>(); \
-    void WriteTypeTo(FxSerializerIO& writer) const \
+    uint16 GetSerializerTypeId_() const \
     { \
-        writer.TypeSection.WriteTypeAndMembers(writer, SerializerTypeId_, sizeof(decltype(*this)), __VA_ARGS__); \
+        return FxSerializeUtil::GetTypeId<decltype(*this)>(); \
+    } \
+    using SerializerMembers_ = decltype(FxValuesToPtrsTuple(__VA_ARGS__)); \
+    bool SerializerIsContiguous_() const \
+    { \
+        return FxMembersAreContiguous(__VA_ARGS__); \
+    } \
+    bool WriteTypeTo(FxSerializerIO& writer) const \
+    { \
+        return writer.TypeSection.WriteTypeForTypeId<std::remove_cvref_t<decltype(*this)>>(); \
     } \
     void WriteTo(FxHash name_hash, FxSerializerIO& writer) const \
     { \
-        WriteTypeTo(writer); \
-        FxSerializeStruct(writer, SerializerTypeId_, name_hash, __VA_ARGS__); \
+        if (!WriteTypeTo(writer)) { \
+            return; \
+        } \
+        writer.AddDirectoryEntry(name_hash, writer.DataSection.Index); \
+        WriteEntryTo(name_hash, writer); \
+    } \
+    void WriteEntryTo(FxHash name_hash, FxSerializerIO& writer) const \
+    { \
+        FxSerializeStruct(writer, GetSerializerTypeId_(), name_hash, __VA_ARGS__); \
     } \
     void ReadFrom(FxHash name_hash, FxSerializerIO& writer) const \
     { \
         FxDeserializeStruct(writer, name_hash, FxValuesToPtrsTuple(__VA_ARGS__)); \
+    } \
+    void WriteDataTo(FxSerializerIO& writer) const \
+    { \
+        FxSerializeMembers(writer, __VA_ARGS__); \
+    } \
+    void ReadDataFrom(FxSerializerIO& reader) const \
+    { \
+        FxDeserializeMembers(reader, FxValuesToPtrsTuple(__VA_ARGS__)); \
     }
@@ -1,6 +1,14 @@
 #pragma once
 
+#include "FxTypes.hpp"
+
+#include <bit>
 #include <utility>
+#include <type_traits>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <stdlib.h>
+#endif
 
 /** Creates a new context that will call the given function at the end of scope */
 template <typename FuncType>
@@ -28,3 +36,75 @@ private:
 #define FX_CONCAT(a_, b_) FX_CONCAT_INNER(a_, b_)
 
 #define FxDefer(fn_) FxDeferObject FX_CONCAT(_ds_, __LINE__)(fn_)
+
+template <size_t Size>
+struct FxUintOfSize_;
+
+template <> struct FxUintOfSize_<1> { using Type = uint8; };
+template <> struct FxUintOfSize_<2> { using Type = uint16; };
+template <> struct FxUintOfSize_<4> { using Type = uint32; };
+template <> struct FxUintOfSize_<8> { using Type = uint64; };
+
+/** Unsigned integer type that is `Size` bytes wide */
+template <size_t Size>
+using FxUintOfSize = typename FxUintOfSize_<Size>::Type;
+
+/** Reverses the byte order of an integer value */
+template <typename T> requires std::is_integral_v<T>
+constexpr T FxByteSwap(T value)
+{
+#ifdef __cpp_lib_byteswap
+    return std::byteswap(value);
+#else
+    using UnsignedType = std::make_unsigned_t<T>;
+    const UnsignedType uvalue = static_cast<UnsignedType>(value);
+
+    if constexpr (sizeof(T) == 1) {
+        return value;
+    }
+    else if (std::is_constant_evaluated()) {
+        UnsignedType result = 0;
+        for (size_t i = 0; i < sizeof(T); i++) {
+            result |= static_cast<UnsignedType>((uvalue >> (i * 8)) & 0xFF) << ((sizeof(T) - 1 - i) * 8);
+        }
+        return static_cast<T>(result);
+    }
+#if defined(_MSC_VER) && !defined(__clang__)
+    else if constexpr (sizeof(T) == 2) {
+        return static_cast<T>(_byteswap_ushort(uvalue));
+    }
+    else if constexpr (sizeof(T) == 4) {
+        return static_cast<T>(_byteswap_ulong(uvalue));
+    }
+    else {
+        return static_cast<T>(_byteswap_uint64(uvalue));
+    }
+#else
+    else if constexpr (sizeof(T) == 2) {
+        return static_cast<T>(__builtin_bswap16(uvalue));
+    }
+    else if constexpr (sizeof(T) == 4) {
+        return static_cast<T>(__builtin_bswap32(uvalue));
+    }
+    else {
+        return static_cast<T>(__builtin_bswap64(uvalue));
+    }
+#endif
+#endif
+}
+
+/** Maps a signed value to an unsigned one so that values close to zero are small (0, -1, 1, -2 -> 0, 1, 2, 3) */
+template <typename T> requires std::is_signed_v<T> && std::is_integral_v<T>
+constexpr std::make_unsigned_t<T> FxZigZagEncode(T value)
+{
+    using UnsignedType = std::make_unsigned_t<T>;
+
+    return static_cast<UnsignedType>(static_cast<UnsignedType>(value) << 1) ^ static_cast<UnsignedType>(value >> (sizeof(T) * 8 - 1));
+}
+
+/** Reverses FxZigZagEncode */
+template <typename T> requires std::is_unsigned_v<T>
+constexpr std::make_signed_t<T> FxZigZagDecode(T value)
+{
+    return static_cast<std::make_signed_t<T>>(static_cast<T>(value >> 1) ^ static_cast<T>(~static_cast<T>(value & 1) + 1));
+}